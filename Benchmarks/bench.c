@@ -0,0 +1,783 @@
+/* Benchmark of the FIFO, LIFO and DLL buffers
+    Runs without any input and prints one result per line, as JSON (default) or as CSV with -c, so
+    the output of two builds can be diffed or loaded into a spreadsheet.
+
+    Every benchmark is run for buffer lengths from L1 resident to DRAM resident:
+
+        Length      1 Ki      16 Ki      256 Ki      4 Mi   (elements of 16 bytes)
+        Resident    L1        L2         L3          DRAM
+
+    and the concurrent variants for 1, 2, 4 and 8 threads. -q stops the sweep at 256 Ki elements.
+    The concurrent DLL buffer is run with 1, 2, 4 and 8 readers walking the list while one writer
+    replaces its elements, and both the readers and the writer are reported.
+
+    The operations are timed in batches of BENCH_BATCH, so the clock costs little next to them, and
+    the latency percentiles are those of the batches, divided by the batch length:
+
+     ___________      ___________      ___________
+    |_OP_|..|_OP_|   |_OP_|..|_OP_|   |_OP_|..|_OP_|   -> sorted ns per op -> p50, p99, p99.9
+      BENCH_BATCH
+
+    The headers are included directly, they only hold static inline functions.
+*/
+
+/* O_CLOEXEC and MADV_* of the persistent FIFO buffer are GNU extensions, needed before any include */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+/* Standard libarary includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <sched.h>
+
+/* The counters of -DBUF_STATS and the trace of -DBUF_TRACE are defined in this file */
+#define BUF_STATS_IMPLEMENTATION
+#define BUF_TRACE_IMPLEMENTATION
+
+#include "../FIFO_Buffer/fifo_buf.h"
+#include "../FIFO_Buffer/fifo_spsc.h"
+#include "../FIFO_Buffer/fifo_mpmc.h"
+#include "../LIFO_Buffer/lifo_buf.h"
+#include "../LIFO_Buffer/lifo_treiber.h"
+#include "../LIFO_Buffer/lifo_magazine.h"
+#include "../Linked_Lists/dll.h"
+#include "../Linked_Lists/dll_rcu.h"
+
+/* Operations timed together for one latency sample */
+#ifndef BENCH_BATCH
+#define BENCH_BATCH             16
+#endif
+
+/* Operations run for each benchmark and length, at least */
+#ifndef BENCH_OPS
+#define BENCH_OPS               (1 << 22)
+#endif
+
+/* Buffer lengths swept, a power of two each */
+#define MIN_LENGTH              (1 << 10)
+#define MAX_LENGTH              (1 << 22)
+#define QUICK_MAX_LENGTH        (1 << 18)
+#define LENGTH_STEP             16
+
+/* Largest number of threads of the concurrent variants */
+#define MAX_THREADS             8
+
+/* Latency samples kept, enough for every batch of a benchmark */
+#define MAX_SAMPLES             ((2 * BENCH_OPS) / BENCH_BATCH + (4 * MAX_LENGTH) / BENCH_BATCH + MAX_THREADS)
+
+/* Largest of two sizes */
+#define MAX_SIZE(a, b)          (((a) > (b)) ? (a) : (b))
+
+/* The data organized in structure */
+typedef struct
+{
+    int idx;
+    int data[3];
+} data_t;
+
+/* Result of one benchmark */
+typedef struct
+{
+    const char *structure;
+    const char *operation;
+    int length;
+    int threads;
+    long long ops;
+    double seconds;
+    double p50_ns;
+    double p99_ns;
+    double p999_ns;
+} result_t;
+
+/* Latency samples of one thread, in ns per batch */
+typedef struct
+{
+    unsigned long long *samples;
+    long long count;
+    long long capacity;
+} recorder_t;
+
+/* Size of the storage, enough for the largest buffer of any benchmark */
+#define STORAGE_SIZE            MAX_SIZE(MAX_SIZE(DLL_STORAGE_SIZE(MAX_LENGTH, sizeof(data_t)),                   \
+                                                  DLL_RCU_STORAGE_SIZE(MAX_LENGTH, sizeof(data_t))),               \
+                                         LIFO_MAG_STORAGE_SIZE(MAX_LENGTH, sizeof(data_t), MAX_THREADS))
+
+/* Static allocation of data is preferred, the storage is shared by the benchmarks one after the other */
+_Alignas(64) unsigned char storage[STORAGE_SIZE];
+unsigned long long samples[MAX_SAMPLES];
+int order[MAX_LENGTH];
+
+fifo_buf_t fifo_buf_ctrl;
+fifo_spsc_t fifo_spsc_ctrl;
+fifo_mpmc_t fifo_mpmc_ctrl;
+lifo_buf_t lifo_buf_ctrl;
+lifo_treiber_t lifo_treiber_ctrl;
+lifo_mag_pool_t lifo_mag_pool_ctrl;
+dll_buf_t dll_buf_ctrl;
+dll_rcu_t dll_rcu_ctrl;
+
+/* Output as CSV instead of JSON */
+bool csv;
+
+/* Sum of what the visits read, so the traversal is not optimized away */
+volatile long long visit_sum;
+
+/* Function to get the time in nanoseconds */
+static inline unsigned long long now_ns (void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return ((unsigned long long)time.tv_sec * 1000000000ull) + (unsigned long long)time.tv_nsec;
+}
+
+/* Function to record the time of a batch started at start */
+static inline void record (recorder_t *recorder, unsigned long long start)
+{
+    if (recorder->count < recorder->capacity)
+    {
+        recorder->samples[recorder->count++] = now_ns() - start;
+    }
+}
+
+/* Function to order the samples for the percentiles */
+int compare_samples (const void *a, const void *b)
+{
+    unsigned long long x = *(const unsigned long long *)a;
+    unsigned long long y = *(const unsigned long long *)b;
+    return (x > y) - (x < y);
+}
+
+/* Function to get a percentile of the sorted samples, in ns per operation of a sample of batch operations */
+double percentile (unsigned long long *sorted, long long count, int batch, double fraction)
+{
+    double ns = 0.0;
+    if (count > 0)
+    {
+        long long rank = (long long)(fraction * (double)(count - 1));
+        ns = (double)sorted[rank] / batch;
+    }
+    return ns;
+}
+
+/* Function to print one result as a JSON object or a CSV row */
+void print_result (result_t *result)
+{
+    double ops_per_sec = (result->seconds > 0.0) ? ((double)result->ops / result->seconds) : 0.0;
+
+    if (csv)
+    {
+        printf("%s,%s,%d,%d,%lld,%.0f,%.2f,%.2f,%.2f\n", result->structure, result->operation, result->length,
+               result->threads, result->ops, ops_per_sec, result->p50_ns, result->p99_ns, result->p999_ns);
+    }
+    else
+    {
+        printf("{\"structure\": \"%s\", \"operation\": \"%s\", \"length\": %d, \"threads\": %d, \"ops\": %lld, "
+               "\"ops_per_sec\": %.0f, \"p50_ns\": %.2f, \"p99_ns\": %.2f, \"p99_9_ns\": %.2f}\n",
+               result->structure, result->operation, result->length, result->threads, result->ops, ops_per_sec,
+               result->p50_ns, result->p99_ns, result->p999_ns);
+    }
+    fflush(stdout);
+}
+
+/* Function to turn the samples at the start of the array, batch operations each, into a result and print it */
+void report (const char *structure, const char *operation, int length, int threads, long long ops,
+             unsigned long long elapsed_ns, long long sample_count, int batch)
+{
+    result_t result = { .structure = structure, .operation = operation, .length = length, .threads = threads,
+                        .ops = ops, .seconds = (double)elapsed_ns / 1e9 };
+
+    qsort(samples, (size_t)sample_count, sizeof(samples[0]), compare_samples);
+    result.p50_ns = percentile(samples, sample_count, batch, 0.50);
+    result.p99_ns = percentile(samples, sample_count, batch, 0.99);
+    result.p999_ns = percentile(samples, sample_count, batch, 0.999);
+    print_result(&result);
+}
+
+/* Function to get the number of fill and drain rounds that make at least BENCH_OPS operations */
+int round_count (int length)
+{
+    return (BENCH_OPS + length - 1) / length;
+}
+
+/* Function to shuffle the order the elements are removed by idx in */
+void shuffle_order (int length)
+{
+    for (int i = 0; i < length; i++)
+    {
+        order[i] = i;
+    }
+    for (int i = length - 1; i > 0; i--)
+    {
+        int j = rand() % (i + 1);
+        int swap = order[i];
+        order[i] = order[j];
+        order[j] = swap;
+    }
+}
+
+/* Function to sum the elements of a traversal */
+void sum_element (int idx, void *element)
+{
+    visit_sum += idx + ((data_t *)element)->data[0];
+}
+
+/* Benchmark of fifo_add and fifo_remove, filling and draining the whole buffer */
+void bench_fifo (int length)
+{
+    recorder_t adds = { samples, 0, MAX_SAMPLES / 2 };
+    recorder_t removes = { samples + (MAX_SAMPLES / 2), 0, MAX_SAMPLES / 2 };
+    unsigned long long add_ns = 0, remove_ns = 0, start, begin;
+    data_t element = { 0, { 0, 0, 0 } };
+    int rounds = round_count(length);
+
+    fifo_init(&fifo_buf_ctrl, storage, length, sizeof(data_t));
+    for (int round = 0; round < rounds; round++)
+    {
+        begin = now_ns();
+        for (int i = 0; i < length; i += BENCH_BATCH)
+        {
+            start = now_ns();
+            for (int j = 0; j < BENCH_BATCH; j++)
+            {
+                element.idx = i + j;
+                (void) fifo_add(&fifo_buf_ctrl, &element);
+            }
+            record(&adds, start);
+        }
+        add_ns += now_ns() - begin;
+
+        begin = now_ns();
+        for (int i = 0; i < length; i += BENCH_BATCH)
+        {
+            start = now_ns();
+            for (int j = 0; j < BENCH_BATCH; j++)
+            {
+                (void) fifo_remove(&fifo_buf_ctrl, &element);
+            }
+            record(&removes, start);
+        }
+        remove_ns += now_ns() - begin;
+    }
+
+    report("fifo_buf", "add", length, 1, (long long)rounds * length, add_ns, adds.count, BENCH_BATCH);
+    (void) memmove(samples, removes.samples, (size_t)removes.count * sizeof(samples[0]));
+    report("fifo_buf", "remove", length, 1, (long long)rounds * length, remove_ns, removes.count, BENCH_BATCH);
+
+    /* Traverse the full buffer, each traversal is one sample */
+    for (int i = 0; i < length; i++)
+    {
+        (void) fifo_add(&fifo_buf_ctrl, &element);
+    }
+    adds.count = 0;
+    begin = now_ns();
+    for (int round = 0; round < rounds; round++)
+    {
+        start = now_ns();
+        (void) fifo_traverse(&fifo_buf_ctrl, sum_element);
+        record(&adds, start);
+    }
+    report("fifo_buf", "traverse", length, 1, (long long)rounds * length, now_ns() - begin, adds.count, length);
+    fifo_deInit(&fifo_buf_ctrl);
+}
+
+/* Benchmark of lifo_push and lifo_pop, filling and draining the whole buffer */
+void bench_lifo (int length)
+{
+    recorder_t pushes = { samples, 0, MAX_SAMPLES / 2 };
+    recorder_t pops = { samples + (MAX_SAMPLES / 2), 0, MAX_SAMPLES / 2 };
+    unsigned long long push_ns = 0, pop_ns = 0, start, begin;
+    data_t element = { 0, { 0, 0, 0 } };
+    int rounds = round_count(length);
+
+    lifo_init(&lifo_buf_ctrl, storage, length, sizeof(data_t));
+    for (int round = 0; round < rounds; round++)
+    {
+        begin = now_ns();
+        for (int i = 0; i < length; i += BENCH_BATCH)
+        {
+            start = now_ns();
+            for (int j = 0; j < BENCH_BATCH; j++)
+            {
+                element.idx = i + j;
+                (void) lifo_push(&lifo_buf_ctrl, &element);
+            }
+            record(&pushes, start);
+        }
+        push_ns += now_ns() - begin;
+
+        begin = now_ns();
+        for (int i = 0; i < length; i += BENCH_BATCH)
+        {
+            start = now_ns();
+            for (int j = 0; j < BENCH_BATCH; j++)
+            {
+                (void) lifo_pop(&lifo_buf_ctrl, &element);
+            }
+            record(&pops, start);
+        }
+        pop_ns += now_ns() - begin;
+    }
+
+    report("lifo_buf", "push", length, 1, (long long)rounds * length, push_ns, pushes.count, BENCH_BATCH);
+    (void) memmove(samples, pops.samples, (size_t)pops.count * sizeof(samples[0]));
+    report("lifo_buf", "pop", length, 1, (long long)rounds * length, pop_ns, pops.count, BENCH_BATCH);
+    lifo_deInit(&lifo_buf_ctrl);
+}
+
+/* Benchmark of dll_add, dll_remove from the head and by idx, and dll_traverse */
+void bench_dll (int length)
+{
+    recorder_t recorder = { samples, 0, MAX_SAMPLES };
+    unsigned long long elapsed_ns = 0, start, begin;
+    data_t element = { 0, { 0, 0, 0 } };
+    int rounds = round_count(length);
+
+    dll_init(&dll_buf_ctrl, storage, length, sizeof(data_t));
+
+    /* Adds, and removes from the head, in the order of insertion */
+    for (int round = 0; round < rounds; round++)
+    {
+        begin = now_ns();
+        for (int i = 0; i < length; i += BENCH_BATCH)
+        {
+            start = now_ns();
+            for (int j = 0; j < BENCH_BATCH; j++)
+            {
+                element.idx = i + j;
+                (void) dll_add(&dll_buf_ctrl, i + j, &element);
+            }
+            record(&recorder, start);
+        }
+        elapsed_ns += now_ns() - begin;
+        for (int i = 0; i < length; i++)
+        {
+            (void) dll_remove(&dll_buf_ctrl, &element, true, 0);
+        }
+    }
+    report("dll_buf", "add", length, 1, (long long)rounds * length, elapsed_ns, recorder.count, BENCH_BATCH);
+
+    recorder.count = 0;
+    elapsed_ns = 0;
+    for (int round = 0; round < rounds; round++)
+    {
+        for (int i = 0; i < length; i++)
+        {
+            element.idx = i;
+            (void) dll_add(&dll_buf_ctrl, i, &element);
+        }
+        begin = now_ns();
+        for (int i = 0; i < length; i += BENCH_BATCH)
+        {
+            start = now_ns();
+            for (int j = 0; j < BENCH_BATCH; j++)
+            {
+                (void) dll_remove(&dll_buf_ctrl, &element, true, 0);
+            }
+            record(&recorder, start);
+        }
+        elapsed_ns += now_ns() - begin;
+    }
+    report("dll_buf", "remove_head", length, 1, (long long)rounds * length, elapsed_ns, recorder.count, BENCH_BATCH);
+
+    /* Removes by idx in a random order, the nodes end up scattered over the pool as in real use */
+    shuffle_order(length);
+    recorder.count = 0;
+    elapsed_ns = 0;
+    for (int round = 0; round < rounds; round++)
+    {
+        for (int i = 0; i < length; i++)
+        {
+            element.idx = i;
+            (void) dll_add(&dll_buf_ctrl, i, &element);
+        }
+        begin = now_ns();
+        for (int i = 0; i < length; i += BENCH_BATCH)
+        {
+            start = now_ns();
+            for (int j = 0; j < BENCH_BATCH; j++)
+            {
+                (void) dll_remove(&dll_buf_ctrl, &element, false, order[i + j]);
+            }
+            record(&recorder, start);
+        }
+        elapsed_ns += now_ns() - begin;
+    }
+    report("dll_buf", "remove_idx", length, 1, (long long)rounds * length, elapsed_ns, recorder.count, BENCH_BATCH);
+
+    /* Traverse the full list, linked in the scattered order the removes by idx left, each traversal is one sample */
+    for (int i = 0; i < length; i++)
+    {
+        element.idx = i;
+        (void) dll_add(&dll_buf_ctrl, i, &element);
+    }
+    recorder.count = 0;
+    begin = now_ns();
+    for (int round = 0; round < rounds; round++)
+    {
+        start = now_ns();
+        (void) dll_traverse(&dll_buf_ctrl, sum_element);
+        record(&recorder, start);
+    }
+    report("dll_buf", "traverse", length, 1, (long long)rounds * length, now_ns() - begin, recorder.count, length);
+    dll_deInit(&dll_buf_ctrl);
+}
+
+/* Work of one thread of a concurrent benchmark */
+typedef struct
+{
+    pthread_t thread;
+    recorder_t recorder;
+    long long ops;
+    bool producer;
+    /* Sum of what the visits of a reader read */
+    long long sum;
+} worker_t;
+
+/* Set when every thread may start */
+atomic_bool go;
+
+/* Set when the readers are done, the writer of the concurrent DLL buffer runs until then */
+atomic_bool stop;
+
+/* Sum of what the visits of the calling reader read, so the walks are not optimized away */
+_Thread_local long long reader_sum;
+
+/* Function for a thread of the MPMC FIFO buffer, adds an element and removes one, over and over */
+void *mpmc_worker (void *arg)
+{
+    worker_t *worker = (worker_t *)arg;
+    data_t element = { 0, { 0, 0, 0 } };
+
+    while (!atomic_load_explicit(&go, memory_order_acquire))
+    {
+    }
+    for (long long i = 0; i < worker->ops; i += BENCH_BATCH)
+    {
+        unsigned long long start = now_ns();
+        for (int j = 0; j < BENCH_BATCH; j += 2)
+        {
+            (void) fifo_mpmc_add(&fifo_mpmc_ctrl, &element);
+            (void) fifo_mpmc_remove(&fifo_mpmc_ctrl, &element);
+        }
+        record(&worker->recorder, start);
+    }
+    return arg;
+}
+
+/* Function for a thread of the lock-free LIFO buffer, pushes an element and pops one, over and over */
+void *treiber_worker (void *arg)
+{
+    worker_t *worker = (worker_t *)arg;
+    data_t element = { 0, { 0, 0, 0 } };
+
+    while (!atomic_load_explicit(&go, memory_order_acquire))
+    {
+    }
+    for (long long i = 0; i < worker->ops; i += BENCH_BATCH)
+    {
+        unsigned long long start = now_ns();
+        for (int j = 0; j < BENCH_BATCH; j += 2)
+        {
+            (void) lifo_treiber_push(&lifo_treiber_ctrl, &element);
+            (void) lifo_treiber_pop(&lifo_treiber_ctrl, &element);
+        }
+        record(&worker->recorder, start);
+    }
+    return arg;
+}
+
+/* Function for a thread of the SPSC FIFO buffer, the producer adds and the consumer removes, yielding when full or empty */
+void *spsc_worker (void *arg)
+{
+    worker_t *worker = (worker_t *)arg;
+    data_t element = { 0, { 0, 0, 0 } };
+
+    while (!atomic_load_explicit(&go, memory_order_acquire))
+    {
+    }
+    for (long long i = 0; i < worker->ops; i += BENCH_BATCH)
+    {
+        unsigned long long start = now_ns();
+        for (int j = 0; j < BENCH_BATCH; j++)
+        {
+            if (worker->producer)
+            {
+                while (fifo_spsc_add(&fifo_spsc_ctrl, &element) != RC_SPSC_OK)
+                {
+                    (void) sched_yield();
+                }
+            }
+            else
+            {
+                while (fifo_spsc_remove(&fifo_spsc_ctrl, &element) != RC_SPSC_OK)
+                {
+                    (void) sched_yield();
+                }
+            }
+        }
+        record(&worker->recorder, start);
+    }
+    return arg;
+}
+
+/* Function for a thread of the object pool, allocates a burst of objects and frees them again, over and over */
+void *magazine_worker (void *arg)
+{
+    worker_t *worker = (worker_t *)arg;
+    lifo_mag_cache_t cache;
+    void *objects[BENCH_BATCH / 2];
+
+    (void) lifo_mag_cache_init(&cache, &lifo_mag_pool_ctrl);
+    while (!atomic_load_explicit(&go, memory_order_acquire))
+    {
+    }
+    for (long long i = 0; i < worker->ops; i += BENCH_BATCH)
+    {
+        unsigned long long start = now_ns();
+        for (int j = 0; j < (BENCH_BATCH / 2); j++)
+        {
+            objects[j] = lifo_mag_alloc(&cache);
+        }
+        for (int j = 0; j < (BENCH_BATCH / 2); j++)
+        {
+            (void) lifo_mag_free(&cache, objects[j]);
+        }
+        record(&worker->recorder, start);
+    }
+    lifo_mag_cache_flush(&cache);
+    return arg;
+}
+
+/* Function to sum the elements of a traversal from a reader thread */
+void sum_reader_element (int idx, void *element)
+{
+    reader_sum += idx + ((data_t *)element)->data[0];
+}
+
+/* Function for a reader of the concurrent DLL buffer, walks the whole list over and over */
+void *rcu_reader_worker (void *arg)
+{
+    worker_t *worker = (worker_t *)arg;
+    int reader = dll_rcu_register(&dll_rcu_ctrl);
+
+    reader_sum = 0;
+    if (reader < 0)
+    {
+        /* No free reader slot, record no samples */
+        fprintf(stderr, "No free dll_rcu reader slot, raise DLL_RCU_MAX_READERS\n");
+        worker->sum = 0;
+        return arg;
+    }
+    while (!atomic_load_explicit(&go, memory_order_acquire))
+    {
+    }
+    for (long long i = 0; i < worker->ops; i++)
+    {
+        unsigned long long start = now_ns();
+        (void) dll_rcu_traverse(&dll_rcu_ctrl, reader, sum_reader_element);
+        record(&worker->recorder, start);
+    }
+    worker->sum = reader_sum;
+    dll_rcu_unregister(&dll_rcu_ctrl, reader);
+    return arg;
+}
+
+/* Function for the writer of the concurrent DLL buffer, removes the head and adds at the tail until the readers are done */
+void *rcu_writer_worker (void *arg)
+{
+    worker_t *worker = (worker_t *)arg;
+    data_t element = { 0, { 0, 0, 0 } };
+    int idx = dll_rcu_ctrl.alloc_count;
+
+    while (!atomic_load_explicit(&go, memory_order_acquire))
+    {
+    }
+    while (!atomic_load_explicit(&stop, memory_order_relaxed))
+    {
+        unsigned long long start = now_ns();
+        for (int j = 0; j < BENCH_BATCH; j += 2)
+        {
+            (void) dll_rcu_remove(&dll_rcu_ctrl, &element, true, 0);
+            element.idx = idx;
+            (void) dll_rcu_add(&dll_rcu_ctrl, idx++, &element);
+        }
+        record(&worker->recorder, start);
+        worker->ops += BENCH_BATCH;
+    }
+    return arg;
+}
+
+/* Function to run the threads of a concurrent benchmark and report them together */
+void run_workers (const char *structure, const char *operation, int length, int threads, void *(*work)(void *))
+{
+    worker_t workers[MAX_THREADS];
+    long long share = MAX_SAMPLES / threads;
+    long long ops = (BENCH_OPS / threads / BENCH_BATCH) * BENCH_BATCH;
+    long long sample_count = 0;
+    unsigned long long begin;
+
+    atomic_store(&go, false);
+    for (int i = 0; i < threads; i++)
+    {
+        workers[i].recorder = (recorder_t){ samples + (i * share), 0, share };
+        workers[i].ops = ops;
+        workers[i].producer = (i == 0);
+        pthread_create(&workers[i].thread, NULL, work, &workers[i]);
+    }
+    begin = now_ns();
+    atomic_store_explicit(&go, true, memory_order_release);
+    for (int i = 0; i < threads; i++)
+    {
+        pthread_join(workers[i].thread, NULL);
+    }
+    unsigned long long elapsed_ns = now_ns() - begin;
+
+    /* Gather the samples of every thread at the start */
+    for (int i = 0; i < threads; i++)
+    {
+        (void) memmove(samples + sample_count, workers[i].recorder.samples,
+                       (size_t)workers[i].recorder.count * sizeof(samples[0]));
+        sample_count += workers[i].recorder.count;
+    }
+    report(structure, operation, length, threads, ops * threads, elapsed_ns, sample_count, BENCH_BATCH);
+}
+
+/* Benchmark of the concurrent variants, the buffers start half full so the whole length is used */
+void bench_concurrent (int length)
+{
+    data_t element = { 0, { 0, 0, 0 } };
+
+    for (int threads = 1; threads <= MAX_THREADS; threads *= 2)
+    {
+        (void) fifo_mpmc_init(&fifo_mpmc_ctrl, storage, (unsigned int)length, sizeof(data_t), false);
+        for (int i = 0; i < (length / 2); i++)
+        {
+            (void) fifo_mpmc_add(&fifo_mpmc_ctrl, &element);
+        }
+        run_workers("fifo_mpmc", "add_remove", length, threads, mpmc_worker);
+        fifo_mpmc_deInit(&fifo_mpmc_ctrl);
+
+        lifo_treiber_init(&lifo_treiber_ctrl, storage, (unsigned int)length, sizeof(data_t));
+        for (int i = 0; i < (length / 2); i++)
+        {
+            (void) lifo_treiber_push(&lifo_treiber_ctrl, &element);
+        }
+        run_workers("lifo_treiber", "push_pop", length, threads, treiber_worker);
+        lifo_treiber_deInit(&lifo_treiber_ctrl);
+
+        /* Every object starts free, in full magazines in the depot */
+        lifo_mag_pool_init(&lifo_mag_pool_ctrl, storage, length, sizeof(data_t), threads);
+        run_workers("lifo_magazine", "alloc_free", length, threads, magazine_worker);
+        lifo_mag_pool_deInit(&lifo_mag_pool_ctrl);
+    }
+
+    /* One producer and one consumer */
+    (void) fifo_spsc_init(&fifo_spsc_ctrl, storage, (unsigned int)length, sizeof(data_t));
+    run_workers("fifo_spsc", "add_remove", length, 2, spsc_worker);
+    fifo_spsc_deInit(&fifo_spsc_ctrl);
+}
+
+/* Benchmark of the concurrent DLL buffer, 1 to MAX_THREADS readers walk the list while one writer replaces its elements
+    The list holds half the length, so the other half cycles through the grace periods. Each walk of a
+    reader is one sample, and the writer reports its removes and adds against that number of readers.
+*/
+void bench_rcu (int length)
+{
+    worker_t readers[MAX_THREADS];
+    worker_t writer;
+    data_t element = { 0, { 0, 0, 0 } };
+    int list_length = length / 2;
+
+    for (int threads = 1; threads <= MAX_THREADS; threads *= 2)
+    {
+        long long share = (MAX_SAMPLES / 2) / threads;
+        long long walks = BENCH_OPS / threads / list_length;
+        long long sample_count = 0;
+        unsigned long long begin, read_ns, write_ns;
+
+        dll_rcu_init(&dll_rcu_ctrl, storage, length, sizeof(data_t));
+        for (int i = 0; i < list_length; i++)
+        {
+            element.idx = i;
+            (void) dll_rcu_add(&dll_rcu_ctrl, i, &element);
+        }
+
+        atomic_store(&go, false);
+        atomic_store(&stop, false);
+        for (int i = 0; i < threads; i++)
+        {
+            readers[i].recorder = (recorder_t){ samples + (i * share), 0, share };
+            readers[i].ops = (walks > 0) ? walks : 1;
+            readers[i].sum = 0;
+            pthread_create(&readers[i].thread, NULL, rcu_reader_worker, &readers[i]);
+        }
+        writer.recorder = (recorder_t){ samples + (MAX_SAMPLES / 2), 0, MAX_SAMPLES / 2 };
+        writer.ops = 0;
+        pthread_create(&writer.thread, NULL, rcu_writer_worker, &writer);
+        begin = now_ns();
+        atomic_store_explicit(&go, true, memory_order_release);
+        for (int i = 0; i < threads; i++)
+        {
+            pthread_join(readers[i].thread, NULL);
+        }
+        read_ns = now_ns() - begin;
+        atomic_store_explicit(&stop, true, memory_order_relaxed);
+        pthread_join(writer.thread, NULL);
+        write_ns = now_ns() - begin;
+
+        /* Gather the samples of every reader at the start */
+        for (int i = 0; i < threads; i++)
+        {
+            (void) memmove(samples + sample_count, readers[i].recorder.samples,
+                           (size_t)readers[i].recorder.count * sizeof(samples[0]));
+            sample_count += readers[i].recorder.count;
+            visit_sum += readers[i].sum;
+        }
+        report("dll_rcu", "traverse", length, threads, readers[0].ops * list_length * threads, read_ns, sample_count,
+               list_length);
+        (void) memmove(samples, writer.recorder.samples, (size_t)writer.recorder.count * sizeof(samples[0]));
+        report("dll_rcu", "remove_add", length, threads, writer.ops, write_ns, writer.recorder.count, BENCH_BATCH);
+        dll_rcu_deInit(&dll_rcu_ctrl);
+    }
+}
+
+int main (int argc, char *argv[])
+{
+    int max_length = MAX_LENGTH;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-c") == 0)
+        {
+            csv = true;
+        }
+        else if (strcmp(argv[i], "-q") == 0)
+        {
+            max_length = QUICK_MAX_LENGTH;
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [-c] [-q]\n  -c  CSV instead of JSON\n  -q  Stop at %d elements\n", argv[0], QUICK_MAX_LENGTH);
+            return 1;
+        }
+    }
+
+    if (csv)
+    {
+        printf("structure,operation,length,threads,ops,ops_per_sec,p50_ns,p99_ns,p99_9_ns\n");
+    }
+    srand(1);
+    for (int length = MIN_LENGTH; length <= max_length; length *= LENGTH_STEP)
+    {
+        bench_fifo(length);
+        bench_lifo(length);
+        bench_dll(length);
+        bench_concurrent(length);
+        bench_rcu(length);
+    }
+    return 0;
+}
@@ -0,0 +1,528 @@
+/* Replay of a trace captured with Common/buf_trace.h
+    Feeds the operations of a trace, in their order, to the FIFO, LIFO and DLL variants chosen on the
+    command line, and prints the throughput and the latency as one JSON line, or as CSV with -c, so
+    two variants or two builds can be compared on the same workload:
+
+        replay [-f buf|mpmc] [-l buf|treiber|segmented] [-d buf|soa|unrolled|skip]
+               [-n length] [-e elem_size] [-c] trace
+
+    The trace is memory-mapped and read once from start to end, the pages already replayed are given
+    back every REPLAY_WINDOW bytes, so a trace larger than the memory can be replayed.
+
+    The records are timed in batches of REPLAY_BATCH, and the ns per batch counted in a histogram
+    with REPLAY_SUB_BUCKETS buckets for every power of two, so the percentiles need no memory for each
+    sample and are within 1 / REPLAY_SUB_BUCKETS of the batch time:
+
+     ___________      ___________
+    |_OP_|..|_OP_|   |_OP_|..|_OP_|   -> histogram of ns per batch -> p50, p99, p99.9 ns per op
+      REPLAY_BATCH
+
+    Every operation that fails where the captured one succeeded, or the other way round, is counted
+    as a mismatch: a buffer shorter than the captured one or a variant that behaves differently. The
+    FIFO buffer refuses adds when full (FIFO_FAIL_FULL), so a capture that overwrote shows mismatches.
+    A FIFO batch of n elements is replayed as a batch of n, and fails when fewer than n are moved.
+*/
+
+/* madvise and O_CLOEXEC of the persistent FIFO buffer are GNU extensions, needed before any include */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+/* Standard libarary includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/* The counters of -DBUF_STATS and the trace of -DBUF_TRACE are defined in this file */
+#define BUF_STATS_IMPLEMENTATION
+#define BUF_TRACE_IMPLEMENTATION
+
+#include "../FIFO_Buffer/fifo_buf.h"
+#include "../FIFO_Buffer/fifo_mpmc.h"
+#include "../LIFO_Buffer/lifo_buf.h"
+#include "../LIFO_Buffer/lifo_treiber.h"
+#include "../LIFO_Buffer/lifo_segmented.h"
+#include "../Linked_Lists/dll.h"
+#include "../Linked_Lists/dll_soa.h"
+#include "../Linked_Lists/dll_unrolled.h"
+#include "../Linked_Lists/dll_skip.h"
+#include "../Common/buf_trace.h"
+
+/* Records timed together for one latency sample */
+#define REPLAY_BATCH            16
+
+/* Elements of a FIFO batch moved in one call, a larger batch is moved in several */
+#define REPLAY_MAX_N            64
+
+/* Bytes of the trace replayed before their pages are given back */
+#define REPLAY_WINDOW           (64u << 20)
+
+/* Histogram of the ns per batch, powers of two up to 2 ^ REPLAY_MAX_BITS split in sub-buckets */
+#define REPLAY_SUB_BITS         3
+#define REPLAY_SUB_BUCKETS      (1 << REPLAY_SUB_BITS)
+#define REPLAY_MAX_BITS         40
+#define REPLAY_BUCKETS          (REPLAY_MAX_BITS * REPLAY_SUB_BUCKETS)
+
+/* Length of the buffers and size of the elements, unless given */
+#define DEFAULT_LENGTH          (1 << 16)
+#define DEFAULT_ELEM_SIZE       16
+#define MAX_ELEM_SIZE           256
+
+/* Elements of a DLL unrolled block */
+#define UNROLLED_BLOCK_LENGTH   32
+
+/* Elements of a LIFO segment */
+#define SEGMENT_LENGTH          256
+
+/* The variants that can replay each kind of buffer */
+typedef enum { FIFO_BUF, FIFO_MPMC } fifo_variant_t;
+typedef enum { LIFO_BUF, LIFO_TREIBER, LIFO_SEGMENTED } lifo_variant_t;
+typedef enum { DLL_BUF, DLL_SOA, DLL_UNROLLED, DLL_SKIP } dll_variant_t;
+
+static const char *const fifo_names[] = { "buf", "mpmc" };
+static const char *const lifo_names[] = { "buf", "treiber", "segmented" };
+static const char *const dll_names[] = { "buf", "soa", "unrolled", "skip" };
+
+/* The buffers, one of each kind is used */
+fifo_buf_t fifo_buf_ctrl;
+fifo_mpmc_t fifo_mpmc_ctrl;
+lifo_buf_t lifo_buf_ctrl;
+lifo_treiber_t lifo_treiber_ctrl;
+lifo_chunk_pool_t lifo_chunk_pool;
+lifo_seg_t lifo_seg_ctrl;
+dll_buf_t dll_buf_ctrl;
+dll_soa_t dll_soa_ctrl;
+dll_unrolled_t dll_unrolled_ctrl;
+dll_skip_t dll_skip_ctrl;
+
+/* The variants chosen, and what the replay counted */
+typedef struct
+{
+    fifo_variant_t fifo;
+    lifo_variant_t lifo;
+    dll_variant_t dll;
+    int length;
+    size_t elem_size;
+    void *storage[BUF_STATS_KINDS];
+    unsigned long long ops[BUF_STATS_KINDS];
+    unsigned long long mismatches;
+    unsigned long long recorded_ns;
+    unsigned long long histogram[REPLAY_BUCKETS];
+    unsigned long long samples;
+} replay_t;
+
+/* Element moved in and out of the buffers, and the elements of a FIFO batch */
+_Alignas(max_align_t) unsigned char element[MAX_ELEM_SIZE];
+_Alignas(max_align_t) unsigned char elements[REPLAY_MAX_N * MAX_ELEM_SIZE];
+
+/* Function to get the time in nanoseconds */
+static inline unsigned long long now_ns (void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return ((unsigned long long)time.tv_sec * 1000000000ull) + (unsigned long long)time.tv_nsec;
+}
+
+/* Function to get the bucket of a time, the power of two then the sub-bucket inside it */
+static inline int bucket_of (unsigned long long ns)
+{
+    int bucket = (int)ns;
+
+    if (ns >= REPLAY_SUB_BUCKETS)
+    {
+        int bits = 63 - __builtin_clzll(ns);
+        int sub = (int)((ns >> (bits - REPLAY_SUB_BITS)) & (REPLAY_SUB_BUCKETS - 1));
+        bucket = ((bits - REPLAY_SUB_BITS + 1) * REPLAY_SUB_BUCKETS) + sub;
+    }
+    return (bucket < REPLAY_BUCKETS) ? bucket : (REPLAY_BUCKETS - 1);
+}
+
+/* Function to get the largest time of a bucket */
+static inline unsigned long long bucket_limit (int bucket)
+{
+    unsigned long long limit = (unsigned long long)bucket;
+
+    if (bucket >= REPLAY_SUB_BUCKETS)
+    {
+        int bits = (bucket / REPLAY_SUB_BUCKETS) + REPLAY_SUB_BITS - 1;
+        int sub = bucket % REPLAY_SUB_BUCKETS;
+        limit = ((1ull << bits) + ((unsigned long long)(sub + 1) << (bits - REPLAY_SUB_BITS))) - 1u;
+    }
+    return limit;
+}
+
+/* Function to get a percentile of the histogram, in ns per operation */
+double percentile (replay_t *replay, double fraction)
+{
+    unsigned long long rank = (unsigned long long)(fraction * (double)replay->samples);
+    unsigned long long seen = 0;
+    int bucket = 0;
+
+    while ((bucket < (REPLAY_BUCKETS - 1)) && ((seen + replay->histogram[bucket]) <= rank))
+    {
+        seen += replay->histogram[bucket];
+        bucket++;
+    }
+    return (double)bucket_limit(bucket) / REPLAY_BATCH;
+}
+
+/* Function to set up the buffers of the chosen variants, returns false if out of memory */
+bool replay_init (replay_t *replay)
+{
+    int length = replay->length;
+    size_t elem_size = replay->elem_size;
+    size_t size[BUF_STATS_KINDS];
+    int chunk_count = (length + SEGMENT_LENGTH - 1) / SEGMENT_LENGTH + 1;
+    /* Blocks part emptied by removes need spares, replay_op still stops the list at length elements */
+    int block_count = (length + UNROLLED_BLOCK_LENGTH - 1) / UNROLLED_BLOCK_LENGTH * 2;
+
+    size[BUF_STATS_FIFO] = (replay->fifo == FIFO_MPMC) ? FIFO_MPMC_STORAGE_SIZE(length, elem_size) : ((size_t)length * elem_size);
+    size[BUF_STATS_LIFO] = (replay->lifo == LIFO_TREIBER) ? LIFO_TREIBER_STORAGE_SIZE(length, elem_size) :
+                           (replay->lifo == LIFO_SEGMENTED) ? LIFO_CHUNK_POOL_SIZE(chunk_count, SEGMENT_LENGTH, elem_size) :
+                           ((size_t)length * elem_size);
+    size[BUF_STATS_DLL] = (replay->dll == DLL_SOA) ? DLL_SOA_STORAGE_SIZE(length, elem_size) :
+                          (replay->dll == DLL_UNROLLED) ? DLL_UNROLLED_STORAGE_SIZE(block_count, UNROLLED_BLOCK_LENGTH, elem_size) :
+                          (replay->dll == DLL_SKIP) ? DLL_SKIP_STORAGE_SIZE(length, elem_size) :
+                          DLL_STORAGE_SIZE(length, elem_size);
+
+    bool allocated = true;
+    for (int kind = 0; kind < BUF_STATS_KINDS; kind++)
+    {
+        /* Round up for aligned_alloc, every variant is happy on a cache line */
+        replay->storage[kind] = aligned_alloc(64u, ((size[kind] + 63u) / 64u) * 64u);
+        allocated = allocated && (replay->storage[kind] != NULL);
+    }
+
+    if (allocated)
+    {
+        if (replay->fifo == FIFO_MPMC)
+        {
+            allocated = (fifo_mpmc_init(&fifo_mpmc_ctrl, replay->storage[BUF_STATS_FIFO], (unsigned int)length, elem_size, false) == RC_MPMC_OK);
+        }
+        else
+        {
+            fifo_init(&fifo_buf_ctrl, replay->storage[BUF_STATS_FIFO], length, elem_size);
+            fifo_set_policy(&fifo_buf_ctrl, FIFO_FAIL_FULL);
+        }
+
+        if (replay->lifo == LIFO_TREIBER)
+        {
+            lifo_treiber_init(&lifo_treiber_ctrl, replay->storage[BUF_STATS_LIFO], (unsigned int)length, elem_size);
+        }
+        else if (replay->lifo == LIFO_SEGMENTED)
+        {
+            lifo_chunk_pool_init(&lifo_chunk_pool, replay->storage[BUF_STATS_LIFO], chunk_count, SEGMENT_LENGTH, elem_size);
+            lifo_seg_init(&lifo_seg_ctrl, &lifo_chunk_pool);
+        }
+        else
+        {
+            lifo_init(&lifo_buf_ctrl, replay->storage[BUF_STATS_LIFO], length, elem_size);
+        }
+
+        if (replay->dll == DLL_SOA)
+        {
+            allocated = allocated && (dll_soa_init(&dll_soa_ctrl, replay->storage[BUF_STATS_DLL], length, elem_size) == RC_DLLBUF_OK);
+        }
+        else if (replay->dll == DLL_UNROLLED)
+        {
+            dll_unrolled_init(&dll_unrolled_ctrl, replay->storage[BUF_STATS_DLL], block_count, UNROLLED_BLOCK_LENGTH, elem_size);
+        }
+        else if (replay->dll == DLL_SKIP)
+        {
+            dll_skip_init(&dll_skip_ctrl, replay->storage[BUF_STATS_DLL], length, elem_size);
+        }
+        else
+        {
+            dll_init(&dll_buf_ctrl, replay->storage[BUF_STATS_DLL], length, elem_size);
+        }
+    }
+    return allocated;
+}
+
+/* Function to move a FIFO batch of n elements, REPLAY_MAX_N at a time, returns true if fewer than n moved */
+static inline bool replay_fifo_n (replay_t *replay, bool add, int n)
+{
+    int moved = 0;
+    int chunk, done;
+
+    do
+    {
+        chunk = ((n - moved) < REPLAY_MAX_N) ? (n - moved) : REPLAY_MAX_N;
+        done = 0;
+        if (replay->fifo == FIFO_MPMC)
+        {
+            /* No batches in the MPMC FIFO, one element after the other until one fails */
+            while ((done < chunk) &&
+                   ((add ? fifo_mpmc_add(&fifo_mpmc_ctrl, element) : fifo_mpmc_remove(&fifo_mpmc_ctrl, element)) == RC_MPMC_OK))
+            {
+                done++;
+            }
+        }
+        else
+        {
+            done = add ? fifo_add_n(&fifo_buf_ctrl, elements, chunk) : fifo_remove_n(&fifo_buf_ctrl, elements, chunk);
+        }
+        moved += done;
+    } while ((done == chunk) && (moved < n));
+    return (moved < n);
+}
+
+/* Function to run one operation of the trace, returns true if it failed */
+static inline bool replay_op (replay_t *replay, const buf_trace_record_t *record)
+{
+    bool failed = false;
+    bool add = ((record->op == BUF_TRACE_ADD) || (record->op == BUF_TRACE_ADD_N));
+    bool conv_remove = (record->op == BUF_TRACE_REMOVE);
+
+    if (record->kind == BUF_STATS_FIFO)
+    {
+        if ((record->op == BUF_TRACE_ADD_N) || (record->op == BUF_TRACE_REMOVE_N))
+        {
+            failed = replay_fifo_n(replay, add, record->idx);
+        }
+        else if (replay->fifo == FIFO_MPMC)
+        {
+            failed = (add ? fifo_mpmc_add(&fifo_mpmc_ctrl, element) : fifo_mpmc_remove(&fifo_mpmc_ctrl, element)) != RC_MPMC_OK;
+        }
+        else
+        {
+            failed = (add ? fifo_add(&fifo_buf_ctrl, element) : fifo_remove(&fifo_buf_ctrl, element)) != RC_FBUF_OK;
+        }
+    }
+    else if (record->kind == BUF_STATS_LIFO)
+    {
+        if (replay->lifo == LIFO_TREIBER)
+        {
+            failed = (add ? lifo_treiber_push(&lifo_treiber_ctrl, element) : lifo_treiber_pop(&lifo_treiber_ctrl, element)) != RC_LBUF_OK;
+        }
+        else if (replay->lifo == LIFO_SEGMENTED)
+        {
+            failed = (add ? lifo_seg_push(&lifo_seg_ctrl, element) : lifo_seg_pop(&lifo_seg_ctrl, element)) != RC_LBUF_OK;
+        }
+        else
+        {
+            failed = (add ? lifo_push(&lifo_buf_ctrl, element) : lifo_pop(&lifo_buf_ctrl, element)) != RC_LBUF_OK;
+        }
+    }
+    else
+    {
+        if (replay->dll == DLL_SOA)
+        {
+            failed = (add ? dll_soa_add(&dll_soa_ctrl, record->idx, element) :
+                            dll_soa_remove(&dll_soa_ctrl, element, conv_remove, record->idx)) != RC_DLLBUF_OK;
+        }
+        else if (replay->dll == DLL_UNROLLED)
+        {
+            /* The blocks have room for more than length elements, so a full list is checked here like the other variants */
+            failed = add ? ((dll_unrolled_ctrl.alloc_count >= replay->length) ||
+                            (dll_unrolled_add(&dll_unrolled_ctrl, record->idx, element) != RC_DLLBUF_OK)) :
+                           (dll_unrolled_remove(&dll_unrolled_ctrl, element, conv_remove, record->idx) != RC_DLLBUF_OK);
+        }
+        else if (replay->dll == DLL_SKIP)
+        {
+            failed = (add ? dll_skip_add(&dll_skip_ctrl, record->idx, element) :
+                            dll_skip_remove(&dll_skip_ctrl, element, conv_remove, record->idx)) != RC_DLLBUF_OK;
+        }
+        else
+        {
+            failed = (add ? dll_add(&dll_buf_ctrl, record->idx, element) :
+                            dll_remove(&dll_buf_ctrl, element, conv_remove, record->idx)) != RC_DLLBUF_OK;
+        }
+    }
+    return failed;
+}
+
+/* Function to replay the records of a mapped trace, returns the ns taken */
+unsigned long long replay_records (replay_t *replay, unsigned char *map, size_t map_size)
+{
+    const buf_trace_record_t *records = (const buf_trace_record_t *)(map + sizeof(buf_trace_header_t));
+    size_t count = (map_size - sizeof(buf_trace_header_t)) / sizeof(buf_trace_record_t);
+    size_t released = 0u;
+    unsigned long long elapsed_ns = 0u;
+
+    for (size_t first = 0u; first < count; first += REPLAY_BATCH)
+    {
+        size_t last = ((first + REPLAY_BATCH) < count) ? (first + REPLAY_BATCH) : count;
+        unsigned long long start = now_ns();
+
+        for (size_t i = first; i < last; i++)
+        {
+            if (replay_op(replay, &records[i]) != (records[i].failed != 0u))
+            {
+                replay->mismatches++;
+            }
+        }
+        unsigned long long batch_ns = now_ns() - start;
+        elapsed_ns += batch_ns;
+
+        /* Only full batches are samples of the latency */
+        if ((last - first) == REPLAY_BATCH)
+        {
+            replay->histogram[bucket_of(batch_ns)]++;
+            replay->samples++;
+        }
+        for (size_t i = first; i < last; i++)
+        {
+            replay->ops[(records[i].kind < BUF_STATS_KINDS) ? records[i].kind : BUF_STATS_DLL]++;
+            replay->recorded_ns += records[i].gap_ns;
+        }
+
+        /* Give back the pages of the trace already replayed */
+        size_t done = sizeof(buf_trace_header_t) + (last * sizeof(buf_trace_record_t));
+        if ((done - released) >= REPLAY_WINDOW)
+        {
+            size_t end = done & ~((size_t)sysconf(_SC_PAGESIZE) - 1u);
+            (void) madvise(map + released, end - released, MADV_DONTNEED);
+            released = end;
+        }
+    }
+    return elapsed_ns;
+}
+
+/* Function to print the result as a JSON object or a CSV row */
+void print_result (replay_t *replay, const char *path, unsigned long long elapsed_ns, bool csv)
+{
+    unsigned long long total = replay->ops[BUF_STATS_FIFO] + replay->ops[BUF_STATS_LIFO] + replay->ops[BUF_STATS_DLL];
+    double ops_per_sec = (elapsed_ns > 0u) ? ((double)total * 1e9 / (double)elapsed_ns) : 0.0;
+    double recorded_per_sec = (replay->recorded_ns > 0u) ? ((double)total * 1e9 / (double)replay->recorded_ns) : 0.0;
+
+    if (csv)
+    {
+        printf("trace,fifo,lifo,dll,length,fifo_ops,lifo_ops,dll_ops,mismatches,ops_per_sec,recorded_ops_per_sec,p50_ns,p99_ns,p99_9_ns\n");
+        printf("%s,%s,%s,%s,%d,%llu,%llu,%llu,%llu,%.0f,%.0f,%.2f,%.2f,%.2f\n", path, fifo_names[replay->fifo],
+               lifo_names[replay->lifo], dll_names[replay->dll], replay->length, replay->ops[BUF_STATS_FIFO],
+               replay->ops[BUF_STATS_LIFO], replay->ops[BUF_STATS_DLL], replay->mismatches, ops_per_sec, recorded_per_sec,
+               percentile(replay, 0.50), percentile(replay, 0.99), percentile(replay, 0.999));
+    }
+    else
+    {
+        printf("{\"trace\": \"%s\", \"fifo\": \"%s\", \"lifo\": \"%s\", \"dll\": \"%s\", \"length\": %d, "
+               "\"fifo_ops\": %llu, \"lifo_ops\": %llu, \"dll_ops\": %llu, \"mismatches\": %llu, "
+               "\"ops_per_sec\": %.0f, \"recorded_ops_per_sec\": %.0f, \"p50_ns\": %.2f, \"p99_ns\": %.2f, \"p99_9_ns\": %.2f}\n",
+               path, fifo_names[replay->fifo], lifo_names[replay->lifo], dll_names[replay->dll], replay->length,
+               replay->ops[BUF_STATS_FIFO], replay->ops[BUF_STATS_LIFO], replay->ops[BUF_STATS_DLL], replay->mismatches,
+               ops_per_sec, recorded_per_sec, percentile(replay, 0.50), percentile(replay, 0.99), percentile(replay, 0.999));
+    }
+}
+
+/* Function to find a name in a list of variant names, returns -1 if it is not there */
+int variant_of (const char *name, const char *const *names, int count)
+{
+    int variant = -1;
+    for (int i = 0; i < count; i++)
+    {
+        if (strcmp(name, names[i]) == 0)
+        {
+            variant = i;
+        }
+    }
+    return variant;
+}
+
+/* Function to print how the replay is used */
+int usage (const char *program)
+{
+    fprintf(stderr, "Usage: %s [-f buf|mpmc] [-l buf|treiber|segmented] [-d buf|soa|unrolled|skip]\n"
+                    "       [-n length] [-e elem_size] [-c] trace\n", program);
+    return 1;
+}
+
+int main (int argc, char *argv[])
+{
+    static replay_t replay;
+    const char *path = NULL;
+    bool csv = false;
+    int variant = 0;
+
+    replay.length = DEFAULT_LENGTH;
+    replay.elem_size = DEFAULT_ELEM_SIZE;
+    for (int i = 1; i < argc; i++)
+    {
+        bool has_value = ((i + 1) < argc);
+        if ((strcmp(argv[i], "-f") == 0) && has_value && ((variant = variant_of(argv[i + 1], fifo_names, 2)) >= 0))
+        {
+            replay.fifo = (fifo_variant_t)variant;
+            i++;
+        }
+        else if ((strcmp(argv[i], "-l") == 0) && has_value && ((variant = variant_of(argv[i + 1], lifo_names, 3)) >= 0))
+        {
+            replay.lifo = (lifo_variant_t)variant;
+            i++;
+        }
+        else if ((strcmp(argv[i], "-d") == 0) && has_value && ((variant = variant_of(argv[i + 1], dll_names, 4)) >= 0))
+        {
+            replay.dll = (dll_variant_t)variant;
+            i++;
+        }
+        else if ((strcmp(argv[i], "-n") == 0) && has_value)
+        {
+            replay.length = atoi(argv[++i]);
+        }
+        else if ((strcmp(argv[i], "-e") == 0) && has_value)
+        {
+            replay.elem_size = (size_t)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-c") == 0)
+        {
+            csv = true;
+        }
+        else if ((argv[i][0] != '-') && (path == NULL))
+        {
+            path = argv[i];
+        }
+        else
+        {
+            return usage(argv[0]);
+        }
+    }
+    if ((path == NULL) || (replay.length < 2) || (replay.elem_size == 0u) || (replay.elem_size > MAX_ELEM_SIZE))
+    {
+        return usage(argv[0]);
+    }
+    if ((replay.fifo == FIFO_MPMC) && ((replay.length & (replay.length - 1)) != 0))
+    {
+        fprintf(stderr, "The MPMC FIFO needs a power of two length\n");
+        return 1;
+    }
+
+    /* Map the trace and check its header, a version 1 trace is one without batches and replays as it is */
+    int fd = open(path, O_RDONLY);
+    struct stat file;
+    unsigned char *map = MAP_FAILED;
+    if ((fd >= 0) && (fstat(fd, &file) == 0) && ((size_t)file.st_size >= sizeof(buf_trace_header_t)))
+    {
+        map = (unsigned char *)mmap(NULL, (size_t)file.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    if (fd >= 0)
+    {
+        (void) close(fd);
+    }
+    const buf_trace_header_t *header = (const buf_trace_header_t *)map;
+    if ((map == MAP_FAILED) || (memcmp(header->magic, BUF_TRACE_MAGIC, sizeof(header->magic)) != 0) ||
+        (header->version < 1u) || (header->version > BUF_TRACE_VERSION) || (header->record_size != sizeof(buf_trace_record_t)))
+    {
+        fprintf(stderr, "%s is not a trace\n", path);
+        return 1;
+    }
+    (void) madvise(map, (size_t)file.st_size, MADV_SEQUENTIAL);
+
+    if (!replay_init(&replay))
+    {
+        fprintf(stderr, "Out of memory for buffers of %d elements\n", replay.length);
+        return 1;
+    }
+    unsigned long long elapsed_ns = replay_records(&replay, map, (size_t)file.st_size);
+    print_result(&replay, path, elapsed_ns, csv);
+
+    (void) munmap(map, (size_t)file.st_size);
+    for (int kind = 0; kind < BUF_STATS_KINDS; kind++)
+    {
+        free(replay.storage[kind]);
+    }
+    return 0;
+}
@@ -0,0 +1,246 @@
+/* Instrumentation of the hot paths of the FIFO, LIFO and DLL buffers, switched on at compile time
+    Built with -DBUF_STATS, the buffers count their operations, the adds refused on a full buffer, the
+    removes from an empty one, the removes of an idx that is not there, the probe steps of the DLL
+    index lookups, the CAS retries of the lock-free variants and the time taken by one operation in every
+    BUF_STATS_SAMPLE_PERIOD. Without it every BUF_STAT_ macro expands to nothing, so the buffers
+    compile to the same code as before.
+
+    Each thread counts in its own slot, on its own cache lines, with plain relaxed stores, so the
+    counters add no shared writes to the hot path. buf_stats_get adds up the slots of every thread
+    for one kind of buffer at any time:
+
+     _______________________      _______________________
+    |_THREAD 0_|_FIFO|LIFO|DLL_| |_THREAD 1_|_FIFO|LIFO|DLL_| ...   -> buf_stats_get -> buf_stats_t
+      Cache line aligned slot
+
+    A thread takes a slot on its first count. Past BUF_STATS_MAX_THREADS threads the rest share one
+    last slot, updated with atomic additions.
+
+    The counters are shared by every translation unit of the program. Exactly one of them defines
+    BUF_STATS_IMPLEMENTATION before including any buffer, and holds the counters.
+*/
+#ifndef BUF_STATS_H
+#define BUF_STATS_H
+
+/* Standard libarary includes */
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+/* The kinds of buffer counted apart */
+typedef enum
+{
+    BUF_STATS_FIFO,
+    BUF_STATS_LIFO,
+    BUF_STATS_DLL,
+    BUF_STATS_KINDS,
+} buf_kind_t;
+
+/* The counters of each kind */
+typedef enum
+{
+    BUF_STAT_OPS,
+    BUF_STAT_FULL,
+    BUF_STAT_EMPTY,
+    BUF_STAT_NOT_FOUND,
+    BUF_STAT_SCAN,
+    BUF_STAT_RETRY,
+    BUF_STAT_TIME,
+    BUF_STAT_SAMPLES,
+    BUF_STAT_COUNTERS,
+} buf_stat_t;
+
+/* Snapshot of the counters of one kind, added up over every thread */
+typedef struct
+{
+    unsigned long long ops;
+    unsigned long long full;
+    unsigned long long empty;
+    unsigned long long not_found;
+    unsigned long long scan;
+    unsigned long long retries;
+    unsigned long long time;
+    unsigned long long samples;
+} buf_stats_t;
+
+#ifdef BUF_STATS
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+
+/* Number of threads with a slot of their own */
+#ifndef BUF_STATS_MAX_THREADS
+#define BUF_STATS_MAX_THREADS   64
+#endif
+
+/* One operation in this many is timed, a power of two */
+#ifndef BUF_STATS_SAMPLE_PERIOD
+#define BUF_STATS_SAMPLE_PERIOD 64u
+#endif
+
+/* Counters of one thread, alone on its cache lines */
+typedef struct
+{
+    _Alignas(64) atomic_ullong counter[BUF_STATS_KINDS][BUF_STAT_COUNTERS];
+} buf_stats_slot_t;
+
+/* The slots, the last one is shared by the threads past BUF_STATS_MAX_THREADS */
+extern buf_stats_slot_t buf_stats_slots[BUF_STATS_MAX_THREADS + 1];
+extern atomic_int buf_stats_threads;
+extern _Thread_local buf_stats_slot_t *buf_stats_local;
+extern _Thread_local unsigned int buf_stats_tick;
+
+#ifdef BUF_STATS_IMPLEMENTATION
+buf_stats_slot_t buf_stats_slots[BUF_STATS_MAX_THREADS + 1];
+atomic_int buf_stats_threads;
+_Thread_local buf_stats_slot_t *buf_stats_local;
+_Thread_local unsigned int buf_stats_tick;
+#endif
+
+/* Function to read the clock of the samples, cycles where there is a cycle counter and ns otherwise */
+static inline unsigned long long buf_stats_clock (void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return ((unsigned long long)time.tv_sec * 1000000000ull) + (unsigned long long)time.tv_nsec;
+#endif
+}
+
+/* Function to get the slot of the calling thread, taking one on its first count */
+static inline buf_stats_slot_t *buf_stats_slot (void)
+{
+    if (buf_stats_local == NULL)
+    {
+        int number = atomic_fetch_add_explicit(&buf_stats_threads, 1, memory_order_relaxed);
+        buf_stats_local = &buf_stats_slots[(number < BUF_STATS_MAX_THREADS) ? number : BUF_STATS_MAX_THREADS];
+    }
+    return buf_stats_local;
+}
+
+/* Function to add n to a counter of the calling thread */
+static inline void buf_stat_add (buf_kind_t kind, buf_stat_t stat, unsigned long long n)
+{
+    buf_stats_slot_t *slot = buf_stats_slot();
+    atomic_ullong *counter = &slot->counter[kind][stat];
+
+    if (slot == &buf_stats_slots[BUF_STATS_MAX_THREADS])
+    {
+        /* The shared slot is written by several threads */
+        (void) atomic_fetch_add_explicit(counter, n, memory_order_relaxed);
+    }
+    else
+    {
+        /* Only the owning thread writes it so no read-modify-write is needed */
+        atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + n, memory_order_relaxed);
+    }
+}
+
+/* Function to start timing an operation, returns 0 unless it is the one sampled in its period */
+static inline unsigned long long buf_stat_start (void)
+{
+    unsigned long long start = 0u;
+
+    if ((++buf_stats_tick & (BUF_STATS_SAMPLE_PERIOD - 1u)) == 0u)
+    {
+        start = buf_stats_clock();
+    }
+    return start;
+}
+
+/* Function to end timing an operation started with buf_stat_start */
+static inline void buf_stat_stop (buf_kind_t kind, unsigned long long start)
+{
+    if (start != 0u)
+    {
+        buf_stat_add(kind, BUF_STAT_TIME, buf_stats_clock() - start);
+        buf_stat_add(kind, BUF_STAT_SAMPLES, 1u);
+    }
+}
+
+/* Macros used on the hot paths */
+#define BUF_STAT_ADD(kind, stat, n)     buf_stat_add((kind), (stat), (n))
+#define BUF_STAT_START(name)            unsigned long long name = buf_stat_start()
+#define BUF_STAT_STOP(kind, name)       buf_stat_stop((kind), (name))
+
+/* Function to add up the counters of every thread for one kind of buffer */
+static inline void buf_stats_get (buf_kind_t kind, buf_stats_t *stats)
+{
+    unsigned long long total[BUF_STAT_COUNTERS] = { 0u };
+
+    for (int i = 0; i <= BUF_STATS_MAX_THREADS; i++)
+    {
+        for (int stat = 0; stat < BUF_STAT_COUNTERS; stat++)
+        {
+            total[stat] += atomic_load_explicit(&buf_stats_slots[i].counter[kind][stat], memory_order_relaxed);
+        }
+    }
+    stats->ops = total[BUF_STAT_OPS];
+    stats->full = total[BUF_STAT_FULL];
+    stats->empty = total[BUF_STAT_EMPTY];
+    stats->not_found = total[BUF_STAT_NOT_FOUND];
+    stats->scan = total[BUF_STAT_SCAN];
+    stats->retries = total[BUF_STAT_RETRY];
+    stats->time = total[BUF_STAT_TIME];
+    stats->samples = total[BUF_STAT_SAMPLES];
+}
+
+/* Function to zero the counters of every thread, counts made at the same time may be lost */
+static inline void buf_stats_reset (void)
+{
+    for (int i = 0; i <= BUF_STATS_MAX_THREADS; i++)
+    {
+        for (int kind = 0; kind < BUF_STATS_KINDS; kind++)
+        {
+            for (int stat = 0; stat < BUF_STAT_COUNTERS; stat++)
+            {
+                atomic_store_explicit(&buf_stats_slots[i].counter[kind][stat], 0u, memory_order_relaxed);
+            }
+        }
+    }
+}
+
+#else /* BUF_STATS */
+
+/* Switched off, the hot paths are left as they are */
+#define BUF_STAT_ADD(kind, stat, n)     ((void)0)
+#define BUF_STAT_START(name)
+#define BUF_STAT_STOP(kind, name)       ((void)0)
+
+/* Function to get the counters of one kind of buffer, all 0 when switched off */
+static inline void buf_stats_get (buf_kind_t kind, buf_stats_t *stats)
+{
+    (void) kind;
+    (void) memset (stats, 0, sizeof(*stats));
+}
+
+/* Function to zero the counters, nothing to do when switched off */
+static inline void buf_stats_reset (void)
+{
+}
+
+#endif /* BUF_STATS */
+
+/* Function to print the counters of one kind of buffer, prints nothing when switched off */
+static inline void buf_stats_print (buf_kind_t kind)
+{
+#ifdef BUF_STATS
+    static const char *const names[BUF_STATS_KINDS] = { "FIFO", "LIFO", "DLL" };
+    buf_stats_t stats;
+
+    buf_stats_get(kind, &stats);
+    printf("\n%s counters: %llu operations, %llu full, %llu empty, %llu not found, %llu scan steps, %llu retries, "
+           "%.1f per sampled operation\n", names[kind], stats.ops, stats.full, stats.empty, stats.not_found,
+           stats.scan, stats.retries, (stats.samples > 0u) ? ((double)stats.time / (double)stats.samples) : 0.0);
+#else
+    (void) kind;
+#endif
+}
+
+#endif /* BUF_STATS_H */
@@ -0,0 +1,209 @@
+/* Capture of the operations on the FIFO, LIFO and DLL buffers, switched on at compile time
+    Built with -DBUF_TRACE, and run with the environment variable BUF_TRACE_FILE naming a file, every
+    add and remove is written to that file as one fixed size record: which kind of buffer, which
+    operation, the idx, whether it failed and the time since the previous operation of the thread.
+    Benchmarks/replay.c feeds such a trace back to any of the buffer variants.
+
+     ________________________________________________
+    |_MAGIC_|_VERSION_|_RECORD SIZE_|_RECORD_|_RECORD_|...   Records until the end of the file
+
+    Each thread collects BUF_TRACE_BATCH records before writing them in one go, so the records of
+    different threads are interleaved by batch. A thread other than the main one calls
+    buf_trace_flush before it ends, the main thread is flushed on exit. The element itself is not
+    recorded, the replay uses elements of the size it is given. A batch of n elements added to or
+    removed from a FIFO buffer is one record, with n in place of the idx.
+
+    The trace file and its state are shared by every translation unit of the program. Exactly one of
+    them defines BUF_TRACE_IMPLEMENTATION before including any buffer, and holds them.
+
+    Without BUF_TRACE every BUF_TRACE_OP expands to nothing.
+*/
+#ifndef BUF_TRACE_H
+#define BUF_TRACE_H
+
+/* Standard libarary includes */
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+/* The kinds of buffer are shared with the counters */
+#include "buf_stats.h"
+
+/* Start of every trace file, and the version of its records */
+#define BUF_TRACE_MAGIC         "BUFTRACE"
+#define BUF_TRACE_VERSION       2u
+
+/* The operations recorded, the batches came with version 2 */
+typedef enum
+{
+    BUF_TRACE_ADD,
+    BUF_TRACE_REMOVE,
+    BUF_TRACE_REMOVE_IDX,
+    BUF_TRACE_ADD_N,
+    BUF_TRACE_REMOVE_N,
+} buf_trace_op_t;
+
+/* Header at the start of a trace file */
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+} buf_trace_header_t;
+
+/* One operation of a trace */
+typedef struct
+{
+    uint32_t gap_ns;
+    int32_t idx;
+    uint8_t kind;
+    uint8_t op;
+    uint8_t failed;
+    uint8_t reserved;
+} buf_trace_record_t;
+
+#ifdef BUF_TRACE
+
+#include <stdlib.h>
+#include <time.h>
+
+/* Records a thread collects before writing them */
+#ifndef BUF_TRACE_BATCH
+#define BUF_TRACE_BATCH         4096
+#endif
+
+/* The trace file, opened on the first record if BUF_TRACE_FILE is set */
+extern FILE *buf_trace_file;
+extern atomic_int buf_trace_state;
+extern atomic_flag buf_trace_lock;
+
+/* The records of the calling thread not yet written */
+extern _Thread_local buf_trace_record_t buf_trace_records[BUF_TRACE_BATCH];
+extern _Thread_local int buf_trace_count;
+extern _Thread_local uint64_t buf_trace_last_ns;
+
+#ifdef BUF_TRACE_IMPLEMENTATION
+FILE *buf_trace_file;
+atomic_int buf_trace_state;
+atomic_flag buf_trace_lock = ATOMIC_FLAG_INIT;
+_Thread_local buf_trace_record_t buf_trace_records[BUF_TRACE_BATCH];
+_Thread_local int buf_trace_count;
+_Thread_local uint64_t buf_trace_last_ns;
+#endif
+
+/* States of the trace file */
+#define BUF_TRACE_CLOSED        0
+#define BUF_TRACE_OPENING       1
+#define BUF_TRACE_OPEN          2
+#define BUF_TRACE_OFF           3
+
+/* Function to get the time in nanoseconds */
+static inline uint64_t buf_trace_now (void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return ((uint64_t)time.tv_sec * 1000000000u) + (uint64_t)time.tv_nsec;
+}
+
+/* Function to write the records of the calling thread to the trace file */
+static inline void buf_trace_flush (void)
+{
+    if ((buf_trace_count > 0) && (atomic_load_explicit(&buf_trace_state, memory_order_acquire) == BUF_TRACE_OPEN))
+    {
+        while (atomic_flag_test_and_set_explicit(&buf_trace_lock, memory_order_acquire))
+        {
+        }
+        (void) fwrite(buf_trace_records, sizeof(buf_trace_record_t), (size_t)buf_trace_count, buf_trace_file);
+        atomic_flag_clear_explicit(&buf_trace_lock, memory_order_release);
+    }
+    buf_trace_count = 0;
+}
+
+/* Function to flush the main thread and close the trace file on exit */
+static void buf_trace_close (void)
+{
+    buf_trace_flush();
+    if (atomic_exchange(&buf_trace_state, BUF_TRACE_OFF) == BUF_TRACE_OPEN)
+    {
+        (void) fclose(buf_trace_file);
+    }
+}
+
+/* Function to open the trace file named by BUF_TRACE_FILE, returns false if there is none */
+static inline bool buf_trace_open (void)
+{
+    int state = atomic_load_explicit(&buf_trace_state, memory_order_acquire);
+    int expected = BUF_TRACE_CLOSED;
+
+    if ((state == BUF_TRACE_CLOSED) &&
+        atomic_compare_exchange_strong(&buf_trace_state, &expected, BUF_TRACE_OPENING))
+    {
+        const char *path = getenv("BUF_TRACE_FILE");
+        buf_trace_header_t header;
+
+        (void) memcpy (header.magic, BUF_TRACE_MAGIC, sizeof(header.magic));
+        header.version = BUF_TRACE_VERSION;
+        header.record_size = (uint32_t)sizeof(buf_trace_record_t);
+
+        buf_trace_file = (path != NULL) ? fopen(path, "wb") : NULL;
+        if ((buf_trace_file != NULL) && (fwrite(&header, sizeof(header), 1, buf_trace_file) == 1u))
+        {
+            (void) atexit(buf_trace_close);
+            state = BUF_TRACE_OPEN;
+        }
+        else
+        {
+            /* Nothing to trace to, stop trying */
+            state = BUF_TRACE_OFF;
+        }
+        atomic_store_explicit(&buf_trace_state, state, memory_order_release);
+    }
+    while (state == BUF_TRACE_OPENING)
+    {
+        /* Another thread is opening the file */
+        state = atomic_load_explicit(&buf_trace_state, memory_order_acquire);
+    }
+    return (state == BUF_TRACE_OPEN);
+}
+
+/* Function to record one operation of the calling thread */
+static inline void buf_trace_op (buf_kind_t kind, buf_trace_op_t op, int idx, bool failed)
+{
+    if (buf_trace_open())
+    {
+        uint64_t now = buf_trace_now();
+        uint64_t gap = (buf_trace_last_ns != 0u) ? (now - buf_trace_last_ns) : 0u;
+        buf_trace_record_t *record = &buf_trace_records[buf_trace_count++];
+
+        record->gap_ns = (gap > UINT32_MAX) ? UINT32_MAX : (uint32_t)gap;
+        record->idx = idx;
+        record->kind = (uint8_t)kind;
+        record->op = (uint8_t)op;
+        record->failed = failed ? 1u : 0u;
+        record->reserved = 0u;
+        buf_trace_last_ns = now;
+        if (buf_trace_count == BUF_TRACE_BATCH)
+        {
+            buf_trace_flush();
+        }
+    }
+}
+
+/* Macro used on the hot paths */
+#define BUF_TRACE_OP(kind, op, idx, failed)     buf_trace_op((kind), (op), (idx), (failed))
+
+#else /* BUF_TRACE */
+
+/* Switched off, the hot paths are left as they are, idx and failed are only read so nothing kept for them goes unused */
+#define BUF_TRACE_OP(kind, op, idx, failed)     ((void)(idx), (void)(failed))
+
+/* Function to write the records of the calling thread, nothing to do when switched off */
+static inline void buf_trace_flush (void)
+{
+}
+
+#endif /* BUF_TRACE */
+
+#endif /* BUF_TRACE_H */
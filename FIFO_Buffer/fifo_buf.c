@@ -1,24 +1,14 @@
-/* A basic implementation of a never full FIFO Circular buffer - elements added to tail, removed from head
-    Both Head and Tail always move in the same direction
-    Empty state,   One element added,            Two more elements added,   One element removed,   Two more Elements added
-     ______          ______                        ______                    ______                  ______                
-    |______|        |______|                      |______|                  |______|                |_DATA_|            
-    |______|        |______|                      |_DATA_| <- TAIL          |_DATA_| <- TAIL        |_DATA_|    
-    |______|        |______|                      |_DATA_|                  |_DATA_| <- HEAD        |_DATA_| <- HEAD    
-    |______|        |_DATA_| <- HEAD,BASE,TAIL    |_DATA_| <- BASE,HEAD     |______| <- BASE        |_DATA_| <- BASE,TAIL 
-
-    Remove two more elements,  Remove one more element
-     ______                      ______   
-    |_DATA_| <- HEAD            |______|
-    |______|                    |______|
-    |______|                    |______|
-    |_DATA_| <- BASE,TAIL       |_DATA_| <- BASE,TAIL,HEAD 
-
+/* Demonstration of the never full FIFO Circular buffer in fifo_buf.h
+    Elements are added to the tail and removed from the head of one buffer instance over a static array.
+    When a file name is given on the command line, the buffer is kept in that file instead, so the
+    elements are still there the next time the program is started with the same file.
 */
 
-/* Standard libarary includes */
-#include <stdio.h>
-#include <string.h>
+/* The counters of -DBUF_STATS and the trace of -DBUF_TRACE are defined in this file */
+#define BUF_STATS_IMPLEMENTATION
+#define BUF_TRACE_IMPLEMENTATION
+
+#include "fifo_buf.h"
 
 /* Buffer size */
 #define BUFFER_LENGTH           4
@@ -33,160 +23,65 @@ typedef struct
 /* Static allocation of data is preferred */
 data_t data[BUFFER_LENGTH];
 
-/* FIFO buffer structure declaration */
-typedef struct 
-{
-    int length;
-    int count;
-    data_t *base;
-    data_t *head;
-    data_t *tail;
-} fifo_buf_t;
-
 fifo_buf_t fifo_buf_ctrl;
 
-/* FIFO buffer return code */
-typedef enum
-{
-    RC_FBUF_OK,
-    RC_FBUF_ERR_EMPTY,
-} fifo_rc_t;
-
-void debug_fifo_pointer(void)
-{
-    printf("\nHead: %d, Tail: %d, Count: %d\n", fifo_buf_ctrl.head - fifo_buf_ctrl.base,
-                        fifo_buf_ctrl.tail - fifo_buf_ctrl.base, fifo_buf_ctrl.count);
-}
-
-/* Function to move a pointer in circular buffer */
-void fifo_increment_pointer (data_t** pointer)
-{
-    /* Increment the pointer */
-    (*pointer)++;
-
-    /*Check bounds, if the pointer has reached the end, then point it to the base */
-    if (*pointer == (fifo_buf_ctrl.base + fifo_buf_ctrl.length)) 
-    {
-        *pointer = fifo_buf_ctrl.base;
-    }
-}
-
-/* Function to check if the FIFO buffer is empty */
-fifo_rc_t fifo_is_bufEmpty (void)
-{
-    fifo_rc_t rc = RC_FBUF_OK;
-
-    /* If the count is 0, then the buffer is empty */
-    if (fifo_buf_ctrl.count == 0) 
-    {
-        rc = RC_FBUF_ERR_EMPTY;
-    }
-    return rc;
-}
-
-/* Funtion to add an element into the FIFO buffer */
-void fifo_add (data_t *element)
-{
-    /* If the count is full, then move the head for overwriting */
-    if (fifo_buf_ctrl.count == fifo_buf_ctrl.length) 
-    {
-        fifo_increment_pointer(&fifo_buf_ctrl.head);
-    }
-
-    /* Increment the count only if the buffer is not full */
-    if (fifo_buf_ctrl.count < fifo_buf_ctrl.length) 
-    {
-        fifo_buf_ctrl.count++;
-    }
+/* The buffer in use, either fifo_buf_ctrl or the one in the file */
+fifo_buf_t *fifo = &fifo_buf_ctrl;
 
-    /* Add the element to the head of the buffer */
-    (void) memset ((void *)fifo_buf_ctrl.tail, 0u, sizeof(element));
-    (void) memcpy ((void *)fifo_buf_ctrl.tail, (void *)element, sizeof(element));
+/* FIFO functions specialized for data_t: data_fifo_add, data_fifo_remove, ... */
+FIFO_BUF_DEFINE(data_fifo, data_t)
 
-    /* Increment the tail pointer of circular buffer */
-    fifo_increment_pointer(&fifo_buf_ctrl.tail);
-}
-
-/* Function to remove an element from the FIFO buffer */
-fifo_rc_t fifo_remove (data_t *element)
+/* Function to print an element while traversing */
+void print_element (int element_number, void *element)
 {
-    /* Check if the buffer is empty */
-    fifo_rc_t rc = fifo_is_bufEmpty();
-
-    if (rc == RC_FBUF_OK) 
-    {
-        /* Decrement the count on removing an element if the buffer is not empty */
-        fifo_buf_ctrl.count--;
-        (void) memcpy ((void *)element, (void *)fifo_buf_ctrl.head, sizeof(element));
-
-        /* Move the tail after removing an element from the tail */
-        fifo_increment_pointer(&fifo_buf_ctrl.head);
-    }
-    return rc;
+    data_t *var = (data_t *)element;
+    printf ("Element %d: Data A: %d, Data B: %d\n", element_number, var->data_1, var->data_2);
 }
 
-/* Function to traverse through the FIFO buffer */
-fifo_rc_t fifo_traverse (void)
+/* Function to print the counters of the buffer */
+void print_stats (void)
 {
-    /* Check if the buffer is empty */
-    fifo_rc_t rc = fifo_is_bufEmpty();
+    fifo_stats_t stats;
+    fifo_get_stats(fifo, &stats);
 
-    if (rc == RC_FBUF_OK) 
+    printf("\nAdded: %llu, Removed: %llu, Overwritten: %llu, Dropped: %llu, Rejected: %llu, High-water: %d\nOccupancy:",
+           stats.enqueued, stats.dequeued, stats.overwritten, stats.dropped, stats.rejected, stats.high_water);
+    for (int i = 0; i < FIFO_HIST_BUCKETS; i++)
     {
-        data_t *traverse_var = fifo_buf_ctrl.head;
-        int element_number = 1;
-        do
-        {
-            /* Print the elements */
-            printf ("Element %d: Data A: %d, Data B: %d\n", element_number++, traverse_var->data_1, traverse_var->data_2);
-            
-            /* Move the traverse pointer till we hit the head */
-            fifo_increment_pointer(&traverse_var);
-        } while (traverse_var != fifo_buf_ctrl.tail);
+        printf(" %llu", stats.histogram[i]);
     }
-    return rc;
-}
-
-/* Initialize the FIFO buffer */
-void fifo_init (void)
-{
-    /* Set the buffer size */
-    fifo_buf_ctrl.length = BUFFER_LENGTH;
-    /* Set the count */
-    fifo_buf_ctrl.count = 0;
-    /* Make the base of the buffer point to the 0th element of the array */
-    fifo_buf_ctrl.base = &data[0];
-    /* Make the head point to the base as the buffer is empty */
-    fifo_buf_ctrl.tail = fifo_buf_ctrl.head = fifo_buf_ctrl.base;
-}
-
-/* De-Initialize the FIFO buffer */
-void fifo_deInit (void)
-{
-    /* Set the buffer size */
-    fifo_buf_ctrl.length = 0;
-    /* Set the count */
-    fifo_buf_ctrl.count = 0;
-    /* Make the base of the buffer point to the 0th element of the array */
-    fifo_buf_ctrl.base = NULL;
-    /* Make the head point to the base as the buffer is empty */
-    fifo_buf_ctrl.tail = fifo_buf_ctrl.head = fifo_buf_ctrl.base;
+    printf("\n");
 }
 
-int main()
+int main(int argc, char *argv[])
 {
     printf("\nCircular FIFO Buffer Implementation. Length of buffer: %d", BUFFER_LENGTH);
     char symbol;
     data_t element;
     fifo_rc_t rc;
+    bool persistent = (argc > 1);
 
-    /* Initialize the FIFO circular buffer */
-    fifo_init();
+    if (persistent)
+    {
+        /* Open the FIFO circular buffer kept in the file, with whatever it held last time */
+        fifo = fifo_open_persistent(argv[1], BUFFER_LENGTH, sizeof(data_t), &rc);
+        if (fifo == NULL)
+        {
+            printf("\nError - %s is not a FIFO buffer file of this length.\n", argv[1]);
+            return 1;
+        }
+        printf("\nOpened %s holding %d elements.", argv[1], fifo->count);
+    }
+    else
+    {
+        /* Initialize the FIFO circular buffer */
+        data_fifo_init(&fifo_buf_ctrl, data, BUFFER_LENGTH);
+    }
 
-    /* 1 to add, 2 to remove, 3 to traverse, and 4 to exit */
+    /* 1 to add, 2 to remove, 3 to traverse, 4 to exit and 5 for the counters */
     while (symbol != '4')
     {
-        printf("\nEnter 1 to add, 2 to remove, 3 to traverse and 4 to exit: ");
+        printf("\nEnter 1 to add, 2 to remove, 3 to traverse, 4 to exit and 5 for the counters: ");
         scanf(" %c", &symbol);
 
         switch (symbol)
@@ -198,17 +93,37 @@ int main()
                 scanf("%d", &element.data_1);
                 printf("Data B: ");
                 scanf("%d", &element.data_2);
-                fifo_add(&element);
 
-                printf("\nElement added successfully.\n");
+                /* A dropped element is still RC_FBUF_OK, the counter tells it apart */
+                fifo_stats_t before, after;
+                fifo_get_stats(fifo, &before);
+                rc = data_fifo_add(fifo, &element);
+                fifo_get_stats(fifo, &after);
+
+                if (rc == RC_FBUF_ERR_FULL)
+                {
+                    printf("\nError - buffer full. Remove an element and try again.\n");
+                }
+                else if (after.dropped != before.dropped)
+                {
+                    printf("\nBuffer full - element dropped.\n");
+                }
+                else if (after.overwritten != before.overwritten)
+                {
+                    printf("\nElement added successfully, the oldest element was overwritten.\n");
+                }
+                else
+                {
+                    printf("\nElement added successfully.\n");
+                }
 
-                debug_fifo_pointer();
+                debug_fifo_pointer(fifo);
             }
             break;
             case '2':
             {
                 /* Remove the element buffer if not empty */
-                rc = fifo_remove(&element);
+                rc = data_fifo_remove(fifo, &element);
                 
                 if (rc == RC_FBUF_OK) {
                     printf("\nElement removed successfully.");
@@ -218,13 +133,13 @@ int main()
                     printf("\nError - buffer empty. Add an element and try again.\n");
                 }
 
-                debug_fifo_pointer();
+                debug_fifo_pointer(fifo);
             }
             break;
             case '3':
             {
                 /* Traverse the FIFO loop */
-                rc = fifo_traverse();
+                rc = fifo_traverse(fifo, print_element);
                 
                 if (rc != RC_FBUF_OK)
                 {
@@ -233,6 +148,12 @@ int main()
                 }
             }
             break;
+            case '5':
+            {
+                /* Show how much was lost and how full the buffer got */
+                print_stats();
+            }
+            break;
             default:
             {
                 /* Break the loop */
@@ -241,8 +162,18 @@ int main()
         }
     }
 
-    /* De-initialize the buffer */
-    fifo_deInit();
+    /* Counters of the hot paths, when built with -DBUF_STATS */
+    buf_stats_print(BUF_STATS_FIFO);
+
+    /* De-initialize the buffer, a persistent one is written back and kept in its file */
+    if (persistent)
+    {
+        fifo_close_persistent(fifo);
+    }
+    else
+    {
+        fifo_deInit(fifo);
+    }
     printf("\nExited program");
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,854 @@
+/* A basic implementation of a never full FIFO Circular buffer - elements added to tail, removed from head
+    Both Head and Tail always move in the same direction
+    Empty state,   One element added,            Two more elements added,   One element removed,   Two more Elements added
+     ______          ______                        ______                    ______                  ______
+    |______|        |______|                      |______|                  |______|                |_DATA_|
+    |______|        |______|                      |_DATA_| <- TAIL          |_DATA_| <- TAIL        |_DATA_|
+    |______|        |______|                      |_DATA_|                  |_DATA_| <- HEAD        |_DATA_| <- HEAD
+    |______|        |_DATA_| <- HEAD,BASE,TAIL    |_DATA_| <- BASE,HEAD     |______| <- BASE        |_DATA_| <- BASE,TAIL
+
+    Remove two more elements,  Remove one more element
+     ______                      ______
+    |_DATA_| <- HEAD            |______|
+    |______|                    |______|
+    |______|                    |______|
+    |_DATA_| <- BASE,TAIL       |_DATA_| <- BASE,TAIL,HEAD
+
+    Every buffer is an instance of fifo_buf_t over storage supplied by the caller, so any number of
+    buffers with different element types and lengths can exist at the same time. Head and tail are
+    element indices from the base.
+
+    The functions work on elements of any size. FIFO_BUF_DEFINE(name, type) generates functions
+    for one element type (name_add, name_remove, ...) that move elements by assignment, so the
+    compiler copies a fixed size inline instead of calling memcpy.
+
+    What happens when an element is added to a full buffer is chosen per instance with fifo_set_policy:
+    - FIFO_OVERWRITE_OLDEST   the head moves and the oldest element is overwritten (default)
+    - FIFO_DROP_NEWEST        the new element is discarded, the add still returns RC_FBUF_OK
+    - FIFO_FAIL_FULL          the new element is refused with RC_FBUF_ERR_FULL
+
+    Every instance keeps counters of lost elements, the high-water mark, the totals added and
+    removed and a histogram of the occupancy seen by each add. The owning thread updates them with
+    plain relaxed atomic stores, so another thread can read them with fifo_get_stats at any time.
+
+    A buffer can also live in a memory-mapped file (fifo_open_persistent), so its elements survive a
+    restart or a crash of the process. The file holds a small header, the fifo_buf_t control block and
+    the ring, so re-opening only maps the file and validates the control block, whatever the backlog.
+*/
+#ifndef FIFO_BUF_H
+#define FIFO_BUF_H
+
+/* memfd_create is a GNU extension */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+/* Standard libarary includes */
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/* Counters and capture of the hot paths, compiled in with -DBUF_STATS and -DBUF_TRACE */
+#include "../Common/buf_stats.h"
+#include "../Common/buf_trace.h"
+
+/* Number of occupancy histogram buckets, bucket i counts adds that found the buffer i/8 full */
+#define FIFO_HIST_BUCKETS       8
+
+/* What an add does when the buffer is full */
+typedef enum
+{
+    FIFO_OVERWRITE_OLDEST,
+    FIFO_DROP_NEWEST,
+    FIFO_FAIL_FULL,
+} fifo_policy_t;
+
+/* Counters of one FIFO buffer, only ever written by the thread using the buffer */
+typedef struct
+{
+    atomic_ullong enqueued;
+    atomic_ullong dequeued;
+    atomic_ullong overwritten;
+    atomic_ullong dropped;
+    atomic_ullong rejected;
+    atomic_int high_water;
+    atomic_ullong histogram[FIFO_HIST_BUCKETS];
+} fifo_counters_t;
+
+/* Snapshot of the counters returned by fifo_get_stats */
+typedef struct
+{
+    unsigned long long enqueued;
+    unsigned long long dequeued;
+    unsigned long long overwritten;
+    unsigned long long dropped;
+    unsigned long long rejected;
+    int high_water;
+    unsigned long long histogram[FIFO_HIST_BUCKETS];
+} fifo_stats_t;
+
+/* FIFO buffer structure declaration */
+typedef struct
+{
+    int length;
+    int count;
+    int head;
+    int tail;
+    /* Free running positions, head and tail are these wrapped at the length, so tail_pos - head_pos is
+       the count even where head == tail cannot tell a full buffer from an empty one */
+    uint64_t head_pos;
+    uint64_t tail_pos;
+    size_t elem_size;
+    unsigned char *base;
+    /* Storage is mapped twice back to back, see fifo_init_mirrored */
+    bool mirrored;
+    size_t map_size;
+    /* Behaviour on a full buffer and the counters */
+    fifo_policy_t policy;
+    uint64_t hist_scale;
+    fifo_counters_t stats;
+} fifo_buf_t;
+
+/* FIFO buffer return code */
+typedef enum
+{
+    RC_FBUF_OK,
+    RC_FBUF_ERR_EMPTY,
+    RC_FBUF_ERR_MAP,
+    RC_FBUF_ERR_FULL,
+    RC_FBUF_ERR_FILE,
+} fifo_rc_t;
+
+/* A run of elements in the buffer, split in two where it wraps around the end of the array */
+typedef struct
+{
+    void *first;
+    int first_count;
+    void *second;
+    int second_count;
+} fifo_span_t;
+
+/* Function called by fifo_traverse for every element, oldest first */
+typedef void (*fifo_visit_t) (int element_number, void *element);
+
+static inline void debug_fifo_pointer (fifo_buf_t *fifo)
+{
+    printf("\nHead: %d, Tail: %d, Count: %d\n", fifo->head, fifo->tail, fifo->count);
+}
+
+/* Function to get the address of the element at an index */
+static inline void *fifo_slot (fifo_buf_t *fifo, int index)
+{
+    return (void *)(fifo->base + ((size_t)index * fifo->elem_size));
+}
+
+/* Function to move an index in circular buffer */
+static inline void fifo_increment_index (fifo_buf_t *fifo, int *index)
+{
+    /* Increment the index */
+    (*index)++;
+
+    /*Check bounds, if the index has reached the end, then point it to the base */
+    if (*index == fifo->length)
+    {
+        *index = 0;
+    }
+}
+
+/* Function to move an index forward by n elements in circular buffer, n must not exceed the length */
+static inline void fifo_advance_index (fifo_buf_t *fifo, int *index, int n)
+{
+    /* Move the index */
+    (*index) += n;
+
+    /* Check bounds, if the index has gone past the end, then wrap it around to the base */
+    if (*index >= fifo->length)
+    {
+        *index -= fifo->length;
+    }
+}
+
+/* Function to move the head forward by n elements as they leave the buffer, n must not exceed the count */
+static inline void fifo_move_head (fifo_buf_t *fifo, int n)
+{
+    fifo->head_pos += (uint64_t)n;
+    fifo_advance_index(fifo, &fifo->head, n);
+}
+
+/* Function to describe n elements starting at an index as at most two contiguous segments */
+static inline void fifo_get_span (fifo_buf_t *fifo, int start, int n, fifo_span_t *span)
+{
+    /* Elements before the end of the array, the rest wrap around to the base */
+    int first = fifo->length - start;
+    if ((first > n) || fifo->mirrored)
+    {
+        /* A mirrored buffer continues past the end into the second mapping, so it never splits */
+        first = n;
+    }
+
+    span->first = fifo_slot(fifo, start);
+    span->first_count = first;
+    span->second = (void *)fifo->base;
+    span->second_count = n - first;
+}
+
+/* Function to add n to a counter, only the owning thread writes it so no read-modify-write is needed */
+static inline void fifo_stat_add (atomic_ullong *counter, unsigned long long n)
+{
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + n, memory_order_relaxed);
+}
+
+/* Function to record the occupancy after elements were added */
+static inline void fifo_stat_occupancy (fifo_buf_t *fifo)
+{
+    /* Bucket the occupancy with a multiply and shift instead of a division */
+    int bucket = (int)(((uint64_t)fifo->count * fifo->hist_scale) >> 32);
+
+    fifo_stat_add(&fifo->stats.histogram[bucket], 1u);
+    if (fifo->count > atomic_load_explicit(&fifo->stats.high_water, memory_order_relaxed))
+    {
+        atomic_store_explicit(&fifo->stats.high_water, fifo->count, memory_order_relaxed);
+    }
+}
+
+/* Function to check if the FIFO buffer is empty */
+static inline fifo_rc_t fifo_is_bufEmpty (fifo_buf_t *fifo)
+{
+    fifo_rc_t rc = RC_FBUF_OK;
+
+    /* If the count is 0, then the buffer is empty */
+    if (fifo->count == 0)
+    {
+        rc = RC_FBUF_ERR_EMPTY;
+    }
+    return rc;
+}
+
+/* Function to make room for an element at the tail, returns the slot the element must be written to
+    Returns NULL when the buffer is full and the policy does not overwrite, with the reason in rc. The
+    element is only in the buffer once it has been written and fifo_add_publish has been called.
+*/
+static inline void *fifo_add_slot (fifo_buf_t *fifo, fifo_rc_t *rc)
+{
+    void *slot = NULL;
+    *rc = RC_FBUF_OK;
+    BUF_STAT_ADD(BUF_STATS_FIFO, BUF_STAT_OPS, 1u);
+
+    /* If the count is full, then move the head for overwriting or give up on the element */
+    if (fifo->count == fifo->length)
+    {
+        if (fifo->policy == FIFO_OVERWRITE_OLDEST)
+        {
+            /* The oldest element leaves before its slot is written, the head moves before the count */
+            fifo_move_head(fifo, 1);
+            atomic_thread_fence(memory_order_release);
+            fifo->count--;
+            fifo_stat_add(&fifo->stats.overwritten, 1u);
+        }
+        else if (fifo->policy == FIFO_DROP_NEWEST)
+        {
+            fifo_stat_add(&fifo->stats.dropped, 1u);
+            BUF_STAT_ADD(BUF_STATS_FIFO, BUF_STAT_FULL, 1u);
+        }
+        else
+        {
+            fifo_stat_add(&fifo->stats.rejected, 1u);
+            BUF_STAT_ADD(BUF_STATS_FIFO, BUF_STAT_FULL, 1u);
+            *rc = RC_FBUF_ERR_FULL;
+        }
+    }
+
+    if (fifo->count < fifo->length)
+    {
+        slot = fifo_slot(fifo, fifo->tail);
+    }
+    return slot;
+}
+
+/* Function to add n elements already written at the tail, n must not exceed the free space
+    The elements are written before tail_pos and the count move and those before the tail, so a persistent
+    buffer cut short at any point never holds an element that was not completely written.
+*/
+static inline void fifo_add_publish (fifo_buf_t *fifo, int n)
+{
+    /* The elements reach memory before the position, the count and the tail that make them visible */
+    atomic_thread_fence(memory_order_release);
+    fifo->tail_pos += (uint64_t)n;
+    fifo->count += n;
+    atomic_thread_fence(memory_order_release);
+
+    /* Move the tail index of circular buffer */
+    fifo_advance_index(fifo, &fifo->tail, n);
+    fifo_stat_add(&fifo->stats.enqueued, (unsigned long long)n);
+    fifo_stat_occupancy(fifo);
+}
+
+/* Funtion to add an element into the FIFO buffer */
+static inline fifo_rc_t fifo_add (fifo_buf_t *fifo, const void *element)
+{
+    BUF_STAT_START(start);
+    fifo_rc_t rc;
+    void *slot = fifo_add_slot(fifo, &rc);
+
+    if (slot != NULL)
+    {
+        /* Add the element to the tail of the buffer, then make it visible */
+        (void) memcpy (slot, element, fifo->elem_size);
+        fifo_add_publish(fifo, 1);
+    }
+    BUF_STAT_STOP(BUF_STATS_FIFO, start);
+    BUF_TRACE_OP(BUF_STATS_FIFO, BUF_TRACE_ADD, 0, (rc != RC_FBUF_OK));
+    return rc;
+}
+
+/* Function to take the element at the head, returns its slot or NULL if the buffer is empty
+    The slot stays valid until the next element is added.
+*/
+static inline void *fifo_remove_slot (fifo_buf_t *fifo)
+{
+    void *slot = NULL;
+    BUF_STAT_ADD(BUF_STATS_FIFO, BUF_STAT_OPS, 1u);
+
+    if (fifo_is_bufEmpty(fifo) == RC_FBUF_OK)
+    {
+        slot = fifo_slot(fifo, fifo->head);
+
+        /* Move the head, then decrement the count on removing an element if the buffer is not empty */
+        fifo_move_head(fifo, 1);
+        atomic_thread_fence(memory_order_release);
+        fifo->count--;
+        fifo_stat_add(&fifo->stats.dequeued, 1u);
+    }
+    else
+    {
+        BUF_STAT_ADD(BUF_STATS_FIFO, BUF_STAT_EMPTY, 1u);
+    }
+    return slot;
+}
+
+/* Function to remove an element from the FIFO buffer */
+static inline fifo_rc_t fifo_remove (fifo_buf_t *fifo, void *element)
+{
+    BUF_STAT_START(start);
+    fifo_rc_t rc = RC_FBUF_ERR_EMPTY;
+    void *slot = fifo_remove_slot(fifo);
+
+    if (slot != NULL)
+    {
+        (void) memcpy (element, slot, fifo->elem_size);
+        rc = RC_FBUF_OK;
+    }
+    BUF_STAT_STOP(BUF_STATS_FIFO, start);
+    BUF_TRACE_OP(BUF_STATS_FIFO, BUF_TRACE_REMOVE, 0, (rc != RC_FBUF_OK));
+    return rc;
+}
+
+/* Funtion to add n elements into the FIFO buffer, returns the number of elements copied into the buffer
+    Like fifo_add, the policy decides what happens to elements that do not fit. When overwriting, only
+    the last length elements of a batch larger than the buffer can be kept, so only those are copied.
+    Otherwise the batch is cut to the free space and the rest is dropped or left with the caller.
+*/
+static inline int fifo_add_n (fifo_buf_t *fifo, const void *elements, int n)
+{
+    const unsigned char *source = (const unsigned char *)elements;
+    int free_count = fifo->length - fifo->count;
+    int requested = n;
+
+    if ((fifo->policy == FIFO_OVERWRITE_OLDEST) && (n > fifo->length))
+    {
+        /* Skip the part of the batch that would be overwritten by the rest of it */
+        source += (size_t)(n - fifo->length) * fifo->elem_size;
+        fifo_stat_add(&fifo->stats.overwritten, (unsigned long long)(n - fifo->length));
+        n = fifo->length;
+    }
+    else if ((fifo->policy != FIFO_OVERWRITE_OLDEST) && (n > free_count))
+    {
+        /* Keep what fits and account for the rest */
+        fifo_stat_add((fifo->policy == FIFO_DROP_NEWEST) ? &fifo->stats.dropped : &fifo->stats.rejected,
+                      (unsigned long long)(n - free_count));
+        n = free_count;
+    }
+
+    if (n > 0)
+    {
+        fifo_span_t span;
+        int overwrite = fifo->count + n - fifo->length;
+
+        if (overwrite > 0)
+        {
+            /* The oldest elements leave before their slots are written, the head moves before the count */
+            fifo_move_head(fifo, overwrite);
+            atomic_thread_fence(memory_order_release);
+            fifo->count -= overwrite;
+            fifo_stat_add(&fifo->stats.overwritten, (unsigned long long)overwrite);
+        }
+        fifo_get_span(fifo, fifo->tail, n, &span);
+
+        /* Copy the batch as at most two contiguous segments */
+        (void) memcpy (span.first, (const void *)source, span.first_count * fifo->elem_size);
+        (void) memcpy (span.second, (const void *)(source + (span.first_count * fifo->elem_size)),
+                       span.second_count * fifo->elem_size);
+
+        /* Move the count and the tail once for the whole batch */
+        fifo_add_publish(fifo, n);
+    }
+    BUF_TRACE_OP(BUF_STATS_FIFO, BUF_TRACE_ADD_N, requested, (n < requested));
+    return n;
+}
+
+/* Function to remove up to n elements from the FIFO buffer, returns the number of elements removed */
+static inline int fifo_remove_n (fifo_buf_t *fifo, void *elements, int n)
+{
+    unsigned char *destination = (unsigned char *)elements;
+    int requested = n;
+
+    /* Remove no more than the buffer holds */
+    if (n > fifo->count)
+    {
+        n = fifo->count;
+    }
+
+    if (n > 0)
+    {
+        fifo_span_t span;
+        fifo_get_span(fifo, fifo->head, n, &span);
+
+        /* Copy the batch out as at most two contiguous segments */
+        (void) memcpy ((void *)destination, span.first, span.first_count * fifo->elem_size);
+        (void) memcpy ((void *)(destination + (span.first_count * fifo->elem_size)), span.second,
+                       span.second_count * fifo->elem_size);
+
+        /* Move the head once for the whole batch, then the count */
+        fifo_move_head(fifo, n);
+        atomic_thread_fence(memory_order_release);
+        fifo->count -= n;
+        fifo_stat_add(&fifo->stats.dequeued, (unsigned long long)n);
+    }
+    BUF_TRACE_OP(BUF_STATS_FIFO, BUF_TRACE_REMOVE_N, requested, (n < requested));
+    return n;
+}
+
+/* Function to reserve up to n free slots for writing in place, returns the number of slots reserved
+    The slots are described by span and are not visible to the consumer until fifo_commit.
+    Reserving never overwrites, so at most length - count slots are handed out.
+*/
+static inline int fifo_reserve (fifo_buf_t *fifo, int n, fifo_span_t *span)
+{
+    /* Reserve no more than the free space */
+    int free_count = fifo->length - fifo->count;
+    if (n > free_count)
+    {
+        n = free_count;
+    }
+
+    /* The free slots start at the tail */
+    fifo_get_span(fifo, fifo->tail, n, span);
+    return n;
+}
+
+/* Function to add n elements written in place after fifo_reserve, returns the number of elements added */
+static inline int fifo_commit (fifo_buf_t *fifo, int n)
+{
+    int requested = n;
+
+    /* Commit no more than the free space */
+    if (n > (fifo->length - fifo->count))
+    {
+        n = fifo->length - fifo->count;
+    }
+
+    /* The elements are already in the buffer, so only the count and the tail move */
+    fifo_add_publish(fifo, n);
+    BUF_TRACE_OP(BUF_STATS_FIFO, BUF_TRACE_ADD_N, requested, (n < requested));
+    return n;
+}
+
+/* Function to look at up to n of the oldest elements in place, returns the number of elements in span
+    The elements stay in the buffer until fifo_release.
+*/
+static inline int fifo_peek (fifo_buf_t *fifo, int n, fifo_span_t *span)
+{
+    /* Peek no more than the buffer holds */
+    if (n > fifo->count)
+    {
+        n = fifo->count;
+    }
+
+    /* The oldest element is at the head */
+    fifo_get_span(fifo, fifo->head, n, span);
+    return n;
+}
+
+/* Function to remove n elements after fifo_peek without copying them, returns the number of elements removed */
+static inline int fifo_release (fifo_buf_t *fifo, int n)
+{
+    int requested = n;
+
+    /* Release no more than the buffer holds */
+    if (n > fifo->count)
+    {
+        n = fifo->count;
+    }
+
+    /* Only the head and the count move, the head first */
+    fifo_move_head(fifo, n);
+    atomic_thread_fence(memory_order_release);
+    fifo->count -= n;
+    fifo_stat_add(&fifo->stats.dequeued, (unsigned long long)n);
+    BUF_TRACE_OP(BUF_STATS_FIFO, BUF_TRACE_REMOVE_N, requested, (n < requested));
+    return n;
+}
+
+/* Function to traverse through the FIFO buffer */
+static inline fifo_rc_t fifo_traverse (fifo_buf_t *fifo, fifo_visit_t visit)
+{
+    /* Check if the buffer is empty */
+    fifo_rc_t rc = fifo_is_bufEmpty(fifo);
+
+    if (rc == RC_FBUF_OK)
+    {
+        int traverse_var = fifo->head;
+        int element_number = 1;
+        do
+        {
+            /* Visit the elements */
+            visit(element_number++, fifo_slot(fifo, traverse_var));
+
+            /* Move the traverse index till we hit the tail */
+            fifo_increment_index(fifo, &traverse_var);
+        } while (traverse_var != fifo->tail);
+    }
+    return rc;
+}
+
+/* Function to clear the counters of the FIFO buffer */
+static inline void fifo_reset_stats (fifo_buf_t *fifo)
+{
+    atomic_store_explicit(&fifo->stats.enqueued, 0u, memory_order_relaxed);
+    atomic_store_explicit(&fifo->stats.dequeued, 0u, memory_order_relaxed);
+    atomic_store_explicit(&fifo->stats.overwritten, 0u, memory_order_relaxed);
+    atomic_store_explicit(&fifo->stats.dropped, 0u, memory_order_relaxed);
+    atomic_store_explicit(&fifo->stats.rejected, 0u, memory_order_relaxed);
+    atomic_store_explicit(&fifo->stats.high_water, 0, memory_order_relaxed);
+    for (int i = 0; i < FIFO_HIST_BUCKETS; i++)
+    {
+        atomic_store_explicit(&fifo->stats.histogram[i], 0u, memory_order_relaxed);
+    }
+}
+
+/* Function to read the counters of the FIFO buffer, safe to call from any thread while the buffer is in use */
+static inline void fifo_get_stats (fifo_buf_t *fifo, fifo_stats_t *stats)
+{
+    stats->enqueued = atomic_load_explicit(&fifo->stats.enqueued, memory_order_relaxed);
+    stats->dequeued = atomic_load_explicit(&fifo->stats.dequeued, memory_order_relaxed);
+    stats->overwritten = atomic_load_explicit(&fifo->stats.overwritten, memory_order_relaxed);
+    stats->dropped = atomic_load_explicit(&fifo->stats.dropped, memory_order_relaxed);
+    stats->rejected = atomic_load_explicit(&fifo->stats.rejected, memory_order_relaxed);
+    stats->high_water = atomic_load_explicit(&fifo->stats.high_water, memory_order_relaxed);
+    for (int i = 0; i < FIFO_HIST_BUCKETS; i++)
+    {
+        stats->histogram[i] = atomic_load_explicit(&fifo->stats.histogram[i], memory_order_relaxed);
+    }
+}
+
+/* Function to choose what an add does when the FIFO buffer is full */
+static inline void fifo_set_policy (fifo_buf_t *fifo, fifo_policy_t policy)
+{
+    fifo->policy = policy;
+}
+
+/* Initialize the FIFO buffer over caller supplied storage of length elements */
+static inline void fifo_init (fifo_buf_t *fifo, void *storage, int length, size_t elem_size)
+{
+    /* Set the buffer size */
+    fifo->length = length;
+    fifo->elem_size = elem_size;
+    /* Set the count */
+    fifo->count = 0;
+    /* Make the base of the buffer point to the 0th element of the storage */
+    fifo->base = (unsigned char *)storage;
+    /* Make the head and tail point to the base as the buffer is empty */
+    fifo->tail = fifo->head = 0;
+    fifo->tail_pos = fifo->head_pos = 0u;
+    /* The caller's storage is mapped once */
+    fifo->mirrored = false;
+    fifo->map_size = 0;
+    /* Overwrite the oldest element by default, as a never full buffer */
+    fifo->policy = FIFO_OVERWRITE_OLDEST;
+    /* Scale so that an occupancy of 0 to length maps onto the buckets 0 to FIFO_HIST_BUCKETS - 1 */
+    fifo->hist_scale = ((uint64_t)FIFO_HIST_BUCKETS << 32) / ((uint64_t)length + 1u);
+    fifo_reset_stats(fifo);
+}
+
+/* Initialize the FIFO buffer over storage mapped twice back to back, so every run of elements is contiguous
+    The same pages are mapped at base and at base + length, so reading or writing past the end of the
+    array lands at the start of it. Spans from fifo_reserve and fifo_peek are then always one segment,
+    and the head and tail only have to be wrapped when they are moved.
+
+     ____________________________________ ____________________________________
+    |_DATA_|_DATA_|______|______|______|_|_DATA_|_DATA_|______|______|______|_|
+    ^ BASE                                ^ BASE + LENGTH (same physical pages)
+
+    The length is rounded up to a whole number of pages, so it is usually larger than the one asked for.
+*/
+static inline fifo_rc_t fifo_init_mirrored (fifo_buf_t *fifo, int length, size_t elem_size)
+{
+    fifo_rc_t rc = RC_FBUF_ERR_MAP;
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    /* Round the storage up to whole pages that also hold a whole number of elements */
+    size_t size = ((((size_t)length * elem_size) + page_size - 1) / page_size) * page_size;
+    while ((size % elem_size) != 0)
+    {
+        size += page_size;
+    }
+
+    /* An anonymous file gives the physical pages that are mapped twice */
+    int fd = memfd_create("fifo_buf", MFD_CLOEXEC);
+    if (fd >= 0)
+    {
+        /* Reserve an address range for both the copies, then map the file over each half */
+        unsigned char *area = mmap(NULL, 2 * size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if ((ftruncate(fd, (off_t)size) == 0) && (area != MAP_FAILED) &&
+            (mmap(area, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED) &&
+            (mmap(area + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED))
+        {
+            /* Set up the buffer over the first mapping with what fits in it */
+            fifo_init(fifo, area, (int)(size / elem_size), elem_size);
+            fifo->mirrored = true;
+            fifo->map_size = size;
+            rc = RC_FBUF_OK;
+        }
+        else if (area != MAP_FAILED)
+        {
+            (void) munmap(area, 2 * size);
+        }
+        /* The mappings keep the pages alive */
+        (void) close(fd);
+    }
+#else
+    (void) fifo;
+    (void) length;
+    (void) elem_size;
+#endif
+    return rc;
+}
+
+/* Identification of a persistent FIFO file, the version changes whenever fifo_buf_t changes */
+#define FIFO_FILE_MAGIC         0x4F464946u
+#define FIFO_FILE_VERSION       2u
+
+/* Start of a persistent FIFO file, the ring follows at data_offset
+     ________ ______________ ______________________________
+    |_HEADER_|__fifo_buf_t__|__________RING DATA___________|
+*/
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t ctrl_size;
+    uint64_t elem_size;
+    uint64_t data_offset;
+    fifo_buf_t fifo;
+} fifo_file_t;
+
+#ifdef __linux__
+/* Function to check the control block of a re-opened file and rebuild the count, head and tail from the positions
+    An add writes its elements, then moves tail_pos. A remove or an overwrite moves head_pos before
+    anything else. Only the free running positions are trusted after a crash: tail_pos only covers
+    elements that are completely written, head_pos is past every element that was handed out, and their
+    difference is the count whether the ring was full or empty. The count and the wrapped indices are
+    rebuilt from them, so a crash between any two stores neither loses an element nor returns one twice.
+*/
+static inline fifo_rc_t fifo_validate_persistent (fifo_file_t *file, int length, size_t elem_size)
+{
+    fifo_rc_t rc = RC_FBUF_ERR_FILE;
+    fifo_buf_t *fifo = &file->fifo;
+
+    if ((file->magic == FIFO_FILE_MAGIC) && (file->version == FIFO_FILE_VERSION) &&
+        (file->ctrl_size == sizeof(fifo_buf_t)) && (file->elem_size == elem_size) &&
+        (fifo->length == length) && (fifo->elem_size == elem_size) && (length > 0) &&
+        (fifo->tail_pos >= fifo->head_pos) && ((fifo->tail_pos - fifo->head_pos) <= (uint64_t)length))
+    {
+        /* Elements between the positions, then the indices they wrap to */
+        fifo->count = (int)(fifo->tail_pos - fifo->head_pos);
+        fifo->head = (int)(fifo->head_pos % (uint64_t)length);
+        fifo->tail = (int)(fifo->tail_pos % (uint64_t)length);
+        rc = RC_FBUF_OK;
+    }
+    return rc;
+}
+
+/* Function to open a FIFO buffer kept in a file, creating it if it does not exist
+    Returns the buffer, which lives in the mapping, or NULL with the reason in rc. An existing file must
+    have been created with the same length and element size. Changes reach the file through the page
+    cache, so they survive the process dying; fifo_sync makes them durable against a system crash.
+*/
+static inline fifo_buf_t *fifo_open_persistent (const char *path, int length, size_t elem_size, fifo_rc_t *rc)
+{
+    fifo_buf_t *fifo = NULL;
+    struct stat file_stat;
+    /* Keep the ring on its own cache lines after the header */
+    size_t data_offset = (sizeof(fifo_file_t) + 63u) & ~(size_t)63u;
+    size_t size = data_offset + ((size_t)length * elem_size);
+
+    *rc = RC_FBUF_ERR_FILE;
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if ((fd >= 0) && (fstat(fd, &file_stat) == 0))
+    {
+        bool created = (file_stat.st_size == 0);
+
+        /* A new file is sized for the ring, an existing one must already have that size */
+        if ((created && (ftruncate(fd, (off_t)size) == 0)) || ((size_t)file_stat.st_size == size))
+        {
+            fifo_file_t *file = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (file != MAP_FAILED)
+            {
+                if (created)
+                {
+                    /* Initialize the control block in the file */
+                    fifo_init(&file->fifo, (unsigned char *)file + data_offset, length, elem_size);
+                    file->ctrl_size = sizeof(fifo_buf_t);
+                    file->elem_size = elem_size;
+                    file->data_offset = data_offset;
+                    file->version = FIFO_FILE_VERSION;
+                    /* The magic goes last, so a file cut short while being created is never accepted */
+                    file->magic = FIFO_FILE_MAGIC;
+                    *rc = RC_FBUF_OK;
+                }
+                else
+                {
+                    *rc = fifo_validate_persistent(file, length, elem_size);
+                }
+
+                if (*rc == RC_FBUF_OK)
+                {
+                    fifo = &file->fifo;
+                    /* The mapping address changes from run to run, everything else is kept as indices */
+                    fifo->base = (unsigned char *)file + data_offset;
+                    fifo->mirrored = false;
+                    fifo->map_size = size;
+                }
+                else
+                {
+                    (void) munmap((void *)file, size);
+                }
+            }
+        }
+    }
+    if (fd >= 0)
+    {
+        /* The mapping keeps the file open */
+        (void) close(fd);
+    }
+    return fifo;
+}
+
+/* Function to get the start of the file mapping from a persistent buffer */
+static inline fifo_file_t *fifo_persistent_file (fifo_buf_t *fifo)
+{
+    return (fifo_file_t *)((unsigned char *)fifo - offsetof(fifo_file_t, fifo));
+}
+
+/* Function to write a persistent buffer back to its file, waiting for the disk when wait is true
+    Calling it once per batch of adds gives a durability point without paying for a sync per element.
+*/
+static inline fifo_rc_t fifo_sync (fifo_buf_t *fifo, bool wait)
+{
+    fifo_rc_t rc = RC_FBUF_OK;
+
+    if (msync((void *)fifo_persistent_file(fifo), fifo->map_size, wait ? MS_SYNC : MS_ASYNC) != 0)
+    {
+        rc = RC_FBUF_ERR_FILE;
+    }
+    return rc;
+}
+
+/* Function to close a persistent buffer, the elements stay in the file for the next fifo_open_persistent */
+static inline void fifo_close_persistent (fifo_buf_t *fifo)
+{
+    size_t size = fifo->map_size;
+
+    (void) fifo_sync(fifo, true);
+    (void) munmap((void *)fifo_persistent_file(fifo), size);
+}
+#endif /* __linux__ */
+
+/* De-Initialize the FIFO buffer */
+static inline void fifo_deInit (fifo_buf_t *fifo)
+{
+#ifdef __linux__
+    /* Release both the mappings of a mirrored buffer */
+    if (fifo->mirrored)
+    {
+        (void) munmap((void *)fifo->base, 2 * fifo->map_size);
+        fifo->mirrored = false;
+    }
+#endif
+    /* Set the buffer size */
+    fifo->length = 0;
+    /* Set the count */
+    fifo->count = 0;
+    /* Make the base of the buffer point to NULL */
+    fifo->base = NULL;
+    /* Make the head and tail point to the base as the buffer is empty */
+    fifo->tail = fifo->head = 0;
+    fifo->tail_pos = fifo->head_pos = 0u;
+}
+
+/* Generate FIFO functions for one element type: name_init, name_add, name_remove, name_add_n and name_remove_n
+    Single elements are moved by assignment, so the copy is a fixed size move the compiler can inline.
+*/
+#define FIFO_BUF_DEFINE(name, type)                                                             \
+    static inline void name##_init (fifo_buf_t *fifo, type *storage, int length)               \
+    {                                                                                           \
+        fifo_init(fifo, (void *)storage, length, sizeof(type));                                 \
+    }                                                                                           \
+    static inline fifo_rc_t name##_add (fifo_buf_t *fifo, const type *element)                 \
+    {                                                                                           \
+        BUF_STAT_START(start);                                                                  \
+        fifo_rc_t rc;                                                                           \
+        type *slot = (type *)fifo_add_slot(fifo, &rc);                                          \
+        if (slot != NULL)                                                                       \
+        {                                                                                       \
+            *slot = *element;                                                                   \
+            fifo_add_publish(fifo, 1);                                                          \
+        }                                                                                       \
+        BUF_STAT_STOP(BUF_STATS_FIFO, start);                                                   \
+        BUF_TRACE_OP(BUF_STATS_FIFO, BUF_TRACE_ADD, 0, (rc != RC_FBUF_OK));                     \
+        return rc;                                                                              \
+    }                                                                                           \
+    static inline fifo_rc_t name##_remove (fifo_buf_t *fifo, type *element)                    \
+    {                                                                                           \
+        BUF_STAT_START(start);                                                                  \
+        fifo_rc_t rc = RC_FBUF_ERR_EMPTY;                                                       \
+        type *slot = (type *)fifo_remove_slot(fifo);                                            \
+        if (slot != NULL)                                                                       \
+        {                                                                                       \
+            *element = *slot;                                                                   \
+            rc = RC_FBUF_OK;                                                                    \
+        }                                                                                       \
+        BUF_STAT_STOP(BUF_STATS_FIFO, start);                                                   \
+        BUF_TRACE_OP(BUF_STATS_FIFO, BUF_TRACE_REMOVE, 0, (rc != RC_FBUF_OK));                  \
+        return rc;                                                                              \
+    }                                                                                           \
+    static inline int name##_add_n (fifo_buf_t *fifo, const type *elements, int n)             \
+    {                                                                                           \
+        return fifo_add_n(fifo, (const void *)elements, n);                                     \
+    }                                                                                           \
+    static inline int name##_remove_n (fifo_buf_t *fifo, type *elements, int n)                \
+    {                                                                                           \
+        return fifo_remove_n(fifo, (void *)elements, n);                                        \
+    }
+
+#endif /* FIFO_BUF_H */
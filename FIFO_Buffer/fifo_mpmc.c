@@ -0,0 +1,241 @@
+/* Demonstration of the lock-free MPMC FIFO buffer in fifo_mpmc.h
+    The same number of producer and consumer threads share one buffer. Every producer adds its
+    share of a known sequence and the consumers check that the sum of what they removed matches,
+    for 1, 2, 4 and 8 threads on each side.
+
+    The runs are repeated on a never full buffer, where the producers overwrite instead of waiting.
+    Every element must then be either removed or counted as overwritten, and each consumer must see
+    the elements of a producer in the order they were added.
+*/
+
+/* Standard libarary includes */
+#include <stdio.h>
+#include <pthread.h>
+#include <time.h>
+#include <sched.h>
+
+/* The counters of -DBUF_STATS and the trace of -DBUF_TRACE are defined in this file */
+#define BUF_STATS_IMPLEMENTATION
+#define BUF_TRACE_IMPLEMENTATION
+
+#include "fifo_mpmc.h"
+
+/* Buffer size, must be a power of two */
+#define BUFFER_LENGTH           1024
+
+/* Number of elements moved through the buffer on each run */
+#define TRANSFER_COUNT          8000000
+
+/* Largest number of producers (and consumers) */
+#define MAX_THREADS             8
+
+/* The data organized in structure */
+typedef struct
+{
+    int data_1;
+    int data_2;
+} data_t;
+
+/* Static allocation of data is preferred */
+_Alignas(MPMC_CACHE_LINE) unsigned char data[FIFO_MPMC_STORAGE_SIZE(BUFFER_LENGTH, sizeof(data_t))];
+
+fifo_mpmc_t fifo_mpmc_ctrl;
+
+/* Work assigned to one thread */
+typedef struct
+{
+    int id;
+    int count;
+    long long sum;
+    long long errors;
+} worker_t;
+
+/* Set when every producer of a never full buffer is done */
+atomic_bool producers_done;
+
+void *producer (void *arg)
+{
+    worker_t *worker = (worker_t *)arg;
+    data_t element;
+
+    for (int i = 0; i < worker->count; i++)
+    {
+        element.data_1 = worker->id;
+        element.data_2 = i;
+        /* Retry while the buffer is full */
+        while (fifo_mpmc_add(&fifo_mpmc_ctrl, &element) != RC_MPMC_OK)
+        {
+            sched_yield();
+        }
+        worker->sum += i;
+    }
+    return arg;
+}
+
+void *consumer (void *arg)
+{
+    worker_t *worker = (worker_t *)arg;
+    data_t element;
+
+    for (int i = 0; i < worker->count; i++)
+    {
+        /* Retry while the buffer is empty */
+        while (fifo_mpmc_remove(&fifo_mpmc_ctrl, &element) != RC_MPMC_OK)
+        {
+            sched_yield();
+        }
+        worker->sum += element.data_2;
+    }
+    return arg;
+}
+
+void *overwriting_producer (void *arg)
+{
+    worker_t *worker = (worker_t *)arg;
+    data_t element;
+
+    for (int i = 0; i < worker->count; i++)
+    {
+        element.data_1 = worker->id;
+        element.data_2 = i;
+        /* The buffer is never full, the oldest element makes room */
+        if (fifo_mpmc_add(&fifo_mpmc_ctrl, &element) != RC_MPMC_OK)
+        {
+            worker->errors++;
+        }
+    }
+    return arg;
+}
+
+void *draining_consumer (void *arg)
+{
+    worker_t *worker = (worker_t *)arg;
+    data_t element;
+    int last[MAX_THREADS];
+
+    for (int i = 0; i < MAX_THREADS; i++)
+    {
+        last[i] = -1;
+    }
+    /* Remove until the producers are done and the buffer is empty, count is what was received */
+    for (;;)
+    {
+        bool done = atomic_load_explicit(&producers_done, memory_order_acquire);
+        if (fifo_mpmc_remove(&fifo_mpmc_ctrl, &element) == RC_MPMC_OK)
+        {
+            /* Positions only grow, so the elements of one producer arrive in order */
+            if ((element.data_1 < 0) || (element.data_1 >= MAX_THREADS) || (element.data_2 <= last[element.data_1]))
+            {
+                worker->errors++;
+            }
+            else
+            {
+                last[element.data_1] = element.data_2;
+            }
+            worker->count++;
+        }
+        else if (done)
+        {
+            break;
+        }
+        else
+        {
+            sched_yield();
+        }
+    }
+    return arg;
+}
+
+/* Function to run producers overwriting a never full buffer against as many consumers */
+void overwrite_run (int thread_count)
+{
+    pthread_t threads[2 * MAX_THREADS];
+    worker_t workers[2 * MAX_THREADS];
+    long long produced = 0, consumed = 0, errors = 0;
+    int share = TRANSFER_COUNT / thread_count;
+
+    (void) fifo_mpmc_init(&fifo_mpmc_ctrl, data, BUFFER_LENGTH, sizeof(data_t), true);
+    atomic_store(&producers_done, false);
+    for (int i = 0; i < thread_count; i++)
+    {
+        workers[i] = (worker_t){ .id = i, .count = share, .sum = 0, .errors = 0 };
+        workers[thread_count + i] = (worker_t){ .id = i, .count = 0, .sum = 0, .errors = 0 };
+        pthread_create(&threads[thread_count + i], NULL, draining_consumer, &workers[thread_count + i]);
+        pthread_create(&threads[i], NULL, overwriting_producer, &workers[i]);
+    }
+    for (int i = 0; i < thread_count; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    atomic_store_explicit(&producers_done, true, memory_order_release);
+    for (int i = 0; i < thread_count; i++)
+    {
+        pthread_join(threads[thread_count + i], NULL);
+    }
+
+    for (int i = 0; i < thread_count; i++)
+    {
+        produced += workers[i].count;
+        consumed += workers[thread_count + i].count;
+        errors += workers[i].errors + workers[thread_count + i].errors;
+    }
+    unsigned long long overwritten = atomic_load(&fifo_mpmc_ctrl.overwritten);
+    printf("%d producers, %d consumers, overwriting: %lld removed, %llu overwritten, %s\n", thread_count,
+           thread_count, consumed, overwritten,
+           ((errors == 0) && ((consumed + (long long)overwritten) == produced)) ? "none lost or out of order" : "MISMATCH");
+
+    fifo_mpmc_deInit(&fifo_mpmc_ctrl);
+}
+
+int main()
+{
+    printf("\nLock-free MPMC FIFO Buffer Implementation. Length of buffer: %d\n", BUFFER_LENGTH);
+    pthread_t threads[2 * MAX_THREADS];
+    worker_t workers[2 * MAX_THREADS];
+    struct timespec start, stop;
+
+    for (int thread_count = 1; thread_count <= MAX_THREADS; thread_count *= 2)
+    {
+        long long produced = 0, consumed = 0;
+        int share = TRANSFER_COUNT / thread_count;
+
+        /* Initialize a buffer that reports full instead of overwriting, so nothing is lost */
+        (void) fifo_mpmc_init(&fifo_mpmc_ctrl, data, BUFFER_LENGTH, sizeof(data_t), false);
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i = 0; i < thread_count; i++)
+        {
+            workers[i] = (worker_t){ .id = i, .count = share, .sum = 0, .errors = 0 };
+            workers[thread_count + i] = (worker_t){ .id = i, .count = share, .sum = 0, .errors = 0 };
+            pthread_create(&threads[thread_count + i], NULL, consumer, &workers[thread_count + i]);
+            pthread_create(&threads[i], NULL, producer, &workers[i]);
+        }
+        for (int i = 0; i < (2 * thread_count); i++)
+        {
+            pthread_join(threads[i], NULL);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+
+        for (int i = 0; i < thread_count; i++)
+        {
+            produced += workers[i].sum;
+            consumed += workers[thread_count + i].sum;
+        }
+
+        double seconds = (stop.tv_sec - start.tv_sec) + ((stop.tv_nsec - start.tv_nsec) / 1e9);
+        printf("%d producers, %d consumers: %.1f million pairs/s, %s\n", thread_count, thread_count,
+               ((share * thread_count) / seconds) / 1e6, (produced == consumed) ? "all elements received" : "MISMATCH");
+
+        fifo_mpmc_deInit(&fifo_mpmc_ctrl);
+    }
+
+    /* The same with a buffer that overwrites the oldest element */
+    printf("\n");
+    for (int thread_count = 1; thread_count <= MAX_THREADS; thread_count *= 2)
+    {
+        overwrite_run(thread_count);
+    }
+
+    printf("\nExited program");
+    return 0;
+}
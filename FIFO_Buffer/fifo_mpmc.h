@@ -0,0 +1,289 @@
+/* A lock-free bounded multi-producer/multi-consumer (MPMC) variant of the circular FIFO buffer
+    Any number of threads may add and remove at the same time.
+
+    Every slot of the ring carries a sequence number next to its element. The sequence tells
+    which lap of the ring the slot belongs to and whether it holds data:
+    - seq == pos             the slot is free for the producer that claims position pos
+    - seq == pos + 1         the slot holds the element added at position pos, ready for a consumer
+    - seq == pos + LENGTH    the slot was emptied and is free for the producer one lap later
+
+    A producer claims a position with a single CAS on the tail, writes the element and then
+    publishes it by storing the sequence. A consumer claims a position with a single CAS on the
+    head, reads the element and then hands the slot to the next lap. Threads only contend on
+    the index CAS, never on a lock, and each slot is only touched by one thread at a time.
+
+     ______________
+    |_SEQ_|__DATA__|
+    |_SEQ_|__DATA__| <- TAIL          Slot = pos & (LENGTH - 1)
+    |_SEQ_|__DATA__|
+    |_SEQ_|__DATA__| <- HEAD
+
+    As with fifo_buf.c, the buffer can either be never full (the oldest element is overwritten)
+    or report RC_MPMC_ERR_FULL, chosen when the buffer is initialized. An overwriting producer only
+    drops the element in the slot it needs, and only while no consumer has claimed it: when a consumer
+    is still copying the element out, the producer waits for it instead of dropping another one.
+*/
+#ifndef FIFO_MPMC_H
+#define FIFO_MPMC_H
+
+/* Standard libarary includes */
+#include <stddef.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+/* Counters and capture of the hot paths, compiled in with -DBUF_STATS and -DBUF_TRACE */
+#include "../Common/buf_stats.h"
+#include "../Common/buf_trace.h"
+
+/* Size of a cache line, used to keep the head and tail indices apart */
+#define MPMC_CACHE_LINE         64
+
+/* Size of one slot: the sequence number followed by the element, rounded up to keep slots aligned */
+#define FIFO_MPMC_SLOT_SIZE(elem_size) \
+    ((sizeof(atomic_uint) + (elem_size) + (_Alignof(max_align_t) - 1u)) & ~(_Alignof(max_align_t) - 1u))
+
+/* Size of the storage the caller must supply for length elements */
+#define FIFO_MPMC_STORAGE_SIZE(length, elem_size)   ((size_t)(length) * FIFO_MPMC_SLOT_SIZE(elem_size))
+
+/* Header of each slot, the element follows it */
+typedef struct
+{
+    atomic_uint seq;
+} fifo_mpmc_slot_t;
+
+/* MPMC FIFO buffer structure declaration */
+typedef struct
+{
+    /* Claimed by consumers */
+    _Alignas(MPMC_CACHE_LINE) atomic_uint head;
+    /* Claimed by producers */
+    _Alignas(MPMC_CACHE_LINE) atomic_uint tail;
+    /* Elements dropped by overwriting adds */
+    atomic_ullong overwritten;
+
+    /* Read only after initialization */
+    _Alignas(MPMC_CACHE_LINE) unsigned int length;
+    unsigned int mask;
+    size_t elem_size;
+    size_t slot_size;
+    bool overwrite;
+    unsigned char *base;
+} fifo_mpmc_t;
+
+/* MPMC FIFO buffer return code */
+typedef enum
+{
+    RC_MPMC_OK,
+    RC_MPMC_ERR_EMPTY,
+    RC_MPMC_ERR_FULL,
+    RC_MPMC_ERR_LENGTH,
+} fifo_mpmc_rc_t;
+
+/* Function to get the slot a position maps to */
+static inline fifo_mpmc_slot_t *fifo_mpmc_slot (fifo_mpmc_t *fifo, unsigned int pos)
+{
+    /* The length is a power of two, so the wrap is a mask */
+    return (fifo_mpmc_slot_t *)(fifo->base + ((size_t)(pos & fifo->mask) * fifo->slot_size));
+}
+
+/* Function to get the element stored in a slot */
+static inline void *fifo_mpmc_element (fifo_mpmc_slot_t *slot)
+{
+    return (void *)((unsigned char *)slot + sizeof(fifo_mpmc_slot_t));
+}
+
+/* Function to claim the oldest element and copy it out */
+static inline fifo_mpmc_rc_t fifo_mpmc_take (fifo_mpmc_t *fifo, void *element)
+{
+    fifo_mpmc_rc_t rc = RC_MPMC_OK;
+    fifo_mpmc_slot_t *slot;
+    unsigned int pos = atomic_load_explicit(&fifo->head, memory_order_relaxed);
+
+    for (;;)
+    {
+        slot = fifo_mpmc_slot(fifo, pos);
+        unsigned int seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        int diff = (int)(seq - (pos + 1u));
+
+        if (diff == 0)
+        {
+            /* The slot holds the element for this position, try to claim it */
+            if (atomic_compare_exchange_weak_explicit(&fifo->head, &pos, pos + 1u,
+                                                      memory_order_relaxed, memory_order_relaxed))
+            {
+                break;
+            }
+            /* Another consumer won, pos now holds the new head */
+            BUF_STAT_ADD(BUF_STATS_FIFO, BUF_STAT_RETRY, 1u);
+        }
+        else if (diff < 0)
+        {
+            /* The producer of this position has not published yet, so the buffer is empty */
+            rc = RC_MPMC_ERR_EMPTY;
+            BUF_STAT_ADD(BUF_STATS_FIFO, BUF_STAT_EMPTY, 1u);
+            break;
+        }
+        else
+        {
+            /* Another consumer already took this position, reload the head */
+            pos = atomic_load_explicit(&fifo->head, memory_order_relaxed);
+            BUF_STAT_ADD(BUF_STATS_FIFO, BUF_STAT_RETRY, 1u);
+        }
+    }
+
+    if (rc == RC_MPMC_OK)
+    {
+        (void) memcpy (element, fifo_mpmc_element(slot), fifo->elem_size);
+        /* Hand the slot to the producer one lap later */
+        atomic_store_explicit(&slot->seq, pos + fifo->length, memory_order_release);
+    }
+    return rc;
+}
+
+/* Funtion to add an element into the MPMC FIFO buffer */
+static inline fifo_mpmc_rc_t fifo_mpmc_add (fifo_mpmc_t *fifo, const void *element)
+{
+    BUF_STAT_START(start);
+    fifo_mpmc_rc_t rc = RC_MPMC_OK;
+    fifo_mpmc_slot_t *slot;
+    unsigned int pos = atomic_load_explicit(&fifo->tail, memory_order_relaxed);
+
+    BUF_STAT_ADD(BUF_STATS_FIFO, BUF_STAT_OPS, 1u);
+    for (;;)
+    {
+        slot = fifo_mpmc_slot(fifo, pos);
+        unsigned int seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        int diff = (int)(seq - pos);
+
+        if (diff == 0)
+        {
+            /* The slot is free for this position, try to claim it */
+            if (atomic_compare_exchange_weak_explicit(&fifo->tail, &pos, pos + 1u,
+                                                      memory_order_relaxed, memory_order_relaxed))
+            {
+                break;
+            }
+            /* Another producer won, pos now holds the new tail */
+            BUF_STAT_ADD(BUF_STATS_FIFO, BUF_STAT_RETRY, 1u);
+        }
+        else if (diff < 0)
+        {
+            /* The slot still holds the element of the previous lap, so the buffer is full */
+            if (!fifo->overwrite)
+            {
+                rc = RC_MPMC_ERR_FULL;
+                BUF_STAT_ADD(BUF_STATS_FIFO, BUF_STAT_FULL, 1u);
+                break;
+            }
+            /* Never full buffer: drop the element of the previous lap, if it is the oldest and no consumer claimed it */
+            unsigned int oldest = pos - fifo->length;
+            if ((seq == (oldest + 1u)) &&
+                atomic_compare_exchange_strong_explicit(&fifo->head, &oldest, oldest + 1u,
+                                                        memory_order_relaxed, memory_order_relaxed))
+            {
+                /* Claimed like a consumer would, hand the slot to this lap without reading it */
+                atomic_store_explicit(&slot->seq, pos, memory_order_release);
+                (void) atomic_fetch_add_explicit(&fifo->overwritten, 1u, memory_order_relaxed);
+            }
+            else
+            {
+                /* A consumer is still releasing the slot or its producer still writing it, look again */
+                pos = atomic_load_explicit(&fifo->tail, memory_order_relaxed);
+                BUF_STAT_ADD(BUF_STATS_FIFO, BUF_STAT_RETRY, 1u);
+            }
+        }
+        else
+        {
+            /* Another producer already took this position, reload the tail */
+            pos = atomic_load_explicit(&fifo->tail, memory_order_relaxed);
+            BUF_STAT_ADD(BUF_STATS_FIFO, BUF_STAT_RETRY, 1u);
+        }
+    }
+
+    if (rc == RC_MPMC_OK)
+    {
+        /* Copy the element and publish it to the consumers */
+        (void) memcpy (fifo_mpmc_element(slot), element, fifo->elem_size);
+        atomic_store_explicit(&slot->seq, pos + 1u, memory_order_release);
+    }
+    BUF_STAT_STOP(BUF_STATS_FIFO, start);
+    BUF_TRACE_OP(BUF_STATS_FIFO, BUF_TRACE_ADD, 0, (rc != RC_MPMC_OK));
+    return rc;
+}
+
+/* Function to remove an element from the MPMC FIFO buffer */
+static inline fifo_mpmc_rc_t fifo_mpmc_remove (fifo_mpmc_t *fifo, void *element)
+{
+    BUF_STAT_START(start);
+    fifo_mpmc_rc_t rc;
+
+    BUF_STAT_ADD(BUF_STATS_FIFO, BUF_STAT_OPS, 1u);
+    rc = fifo_mpmc_take(fifo, element);
+    BUF_STAT_STOP(BUF_STATS_FIFO, start);
+    BUF_TRACE_OP(BUF_STATS_FIFO, BUF_TRACE_REMOVE, 0, (rc != RC_MPMC_OK));
+    return rc;
+}
+
+/* Function to check if the MPMC FIFO buffer is empty, only a snapshot while other threads run */
+static inline fifo_mpmc_rc_t fifo_mpmc_is_bufEmpty (fifo_mpmc_t *fifo)
+{
+    fifo_mpmc_rc_t rc = RC_MPMC_OK;
+
+    /* No position has been claimed past the head */
+    if (atomic_load_explicit(&fifo->head, memory_order_acquire) ==
+        atomic_load_explicit(&fifo->tail, memory_order_acquire))
+    {
+        rc = RC_MPMC_ERR_EMPTY;
+    }
+    return rc;
+}
+
+/* Initialize the MPMC FIFO buffer over caller supplied storage of FIFO_MPMC_STORAGE_SIZE bytes */
+static inline fifo_mpmc_rc_t fifo_mpmc_init (fifo_mpmc_t *fifo, void *storage, unsigned int length,
+                                             size_t elem_size, bool overwrite)
+{
+    fifo_mpmc_rc_t rc = RC_MPMC_OK;
+
+    /* The length must be a power of two (at least 2) for the index mask and the lap sequences */
+    if ((length < 2u) || ((length & (length - 1u)) != 0u))
+    {
+        rc = RC_MPMC_ERR_LENGTH;
+    }
+    else
+    {
+        /* Set the buffer size and the wrap mask */
+        fifo->length = length;
+        fifo->mask = length - 1u;
+        fifo->elem_size = elem_size;
+        fifo->slot_size = FIFO_MPMC_SLOT_SIZE(elem_size);
+        fifo->overwrite = overwrite;
+        /* Make the base of the buffer point to the caller's storage */
+        fifo->base = (unsigned char *)storage;
+
+        /* Every slot starts free for the producer of the first lap */
+        for (unsigned int i = 0; i < length; i++)
+        {
+            atomic_init(&fifo_mpmc_slot(fifo, i)->seq, i);
+        }
+        /* Both indices start at zero as the buffer is empty */
+        atomic_init(&fifo->head, 0u);
+        atomic_init(&fifo->tail, 0u);
+        atomic_init(&fifo->overwritten, 0u);
+    }
+    return rc;
+}
+
+/* De-Initialize the MPMC FIFO buffer */
+static inline void fifo_mpmc_deInit (fifo_mpmc_t *fifo)
+{
+    /* Set the buffer size */
+    fifo->length = fifo->mask = 0u;
+    /* Make the base of the buffer point to NULL */
+    fifo->base = NULL;
+    /* Reset both the indices */
+    atomic_store(&fifo->head, 0u);
+    atomic_store(&fifo->tail, 0u);
+}
+
+#endif /* FIFO_MPMC_H */
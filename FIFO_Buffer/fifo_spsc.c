@@ -0,0 +1,238 @@
+/* Demonstration of the lock-free SPSC FIFO buffer in fifo_spsc.h
+    A producer thread adds a running sequence of elements and a consumer thread removes them,
+    checking that every element arrives exactly once and in order. Both threads are pinned to
+    separate cores when the system has more than one.
+
+    A second run sends bursts with idle gaps between them. The consumer blocks in fifo_spsc_remove_wait
+    and the producer only makes the wake system call when it is asleep, so the consumer uses next to
+    no CPU while idle.
+
+    A last run creates the buffer in shared memory and forks a consumer process that attaches to it
+    by name, so the elements move between two processes without a system call per element.
+*/
+#define _GNU_SOURCE
+
+/* Standard libarary includes */
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "fifo_spsc.h"
+
+/* Buffer size, must be a power of two */
+#define BUFFER_LENGTH           1024
+
+/* Number of elements moved from the producer to the consumer */
+#define TRANSFER_COUNT          50000000
+
+/* Bursts sent in the blocking run, their size and the idle gap between them */
+#define BURST_COUNT             20
+#define BURST_LENGTH            500
+#define BURST_GAP_MS            25
+
+/* Name of the shared memory segment and the number of elements sent through it */
+#define SHM_NAME                "/fifo_spsc_demo"
+#define SHM_TRANSFER_COUNT      10000000
+
+/* Time the consumer process waits for the segment to be ready */
+#define SHM_ATTACH_TIMEOUT_MS   1000
+
+/* The data organized in structure */
+typedef struct
+{
+    int data_1;
+    int data_2;
+} data_t;
+
+/* Static allocation of data is preferred */
+data_t data[BUFFER_LENGTH];
+
+fifo_spsc_t fifo_spsc_ctrl;
+
+/* Function to pin the calling thread to a core, ignored if the core does not exist */
+void pin_to_core (int core)
+{
+    cpu_set_t set;
+
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    (void) pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+void *producer (void *arg)
+{
+    data_t element;
+
+    pin_to_core(0);
+    for (int i = 0; i < TRANSFER_COUNT; i++)
+    {
+        element.data_1 = i;
+        element.data_2 = -i;
+        /* Spin while the consumer catches up */
+        while (fifo_spsc_add(&fifo_spsc_ctrl, &element) != RC_SPSC_OK)
+        {
+            sched_yield();
+        }
+    }
+    return arg;
+}
+
+void *consumer (void *arg)
+{
+    data_t element;
+    long *errors = (long *)arg;
+
+    pin_to_core(1);
+    for (int i = 0; i < TRANSFER_COUNT; i++)
+    {
+        /* Spin while the producer fills the buffer */
+        while (fifo_spsc_remove(&fifo_spsc_ctrl, &element) != RC_SPSC_OK)
+        {
+            sched_yield();
+        }
+        /* Elements must arrive in the order they were added */
+        if ((element.data_1 != i) || (element.data_2 != -i))
+        {
+            (*errors)++;
+        }
+    }
+    return arg;
+}
+
+void *burst_producer (void *arg)
+{
+    data_t element;
+    struct timespec gap = { .tv_sec = 0, .tv_nsec = BURST_GAP_MS * 1000000L };
+
+    for (int burst = 0; burst < BURST_COUNT; burst++)
+    {
+        nanosleep(&gap, NULL);
+        for (int i = 0; i < BURST_LENGTH; i++)
+        {
+            element.data_1 = (burst * BURST_LENGTH) + i;
+            element.data_2 = 0;
+            (void) fifo_spsc_add_wait(&fifo_spsc_ctrl, &element, SPSC_WAIT_FOREVER);
+        }
+    }
+    return arg;
+}
+
+void *blocking_consumer (void *arg)
+{
+    data_t element;
+    double *cpu_seconds = (double *)arg;
+    struct timespec cpu;
+
+    for (int i = 0; i < (BURST_COUNT * BURST_LENGTH); i++)
+    {
+        /* Sleeps in the kernel between bursts instead of polling */
+        (void) fifo_spsc_remove_wait(&fifo_spsc_ctrl, &element, SPSC_WAIT_FOREVER);
+    }
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+    *cpu_seconds = cpu.tv_sec + (cpu.tv_nsec / 1e9);
+    return arg;
+}
+
+/* Consumer process of the shared memory run, returns the number of elements out of order */
+int shm_consumer (void)
+{
+    fifo_spsc_rc_t rc;
+    data_t element;
+    int errors = 0;
+    /* Attach by name, as an unrelated process would */
+    fifo_spsc_t *shared = fifo_spsc_shm_attach(SHM_NAME, SHM_ATTACH_TIMEOUT_MS, &rc);
+
+    if (shared == NULL)
+    {
+        return 1;
+    }
+    for (int i = 0; i < SHM_TRANSFER_COUNT; i++)
+    {
+        (void) fifo_spsc_remove_wait(shared, &element, SPSC_WAIT_FOREVER);
+        if (element.data_1 != i)
+        {
+            errors++;
+        }
+    }
+    fifo_spsc_shm_detach(shared);
+    return (errors == 0) ? 0 : 1;
+}
+
+int main()
+{
+    printf("\nLock-free SPSC FIFO Buffer Implementation. Length of buffer: %d\n", BUFFER_LENGTH);
+    pthread_t producer_thread, consumer_thread;
+    struct timespec start, stop;
+    long errors = 0;
+
+    /* Initialize the SPSC FIFO buffer over the static storage */
+    if (fifo_spsc_init(&fifo_spsc_ctrl, data, BUFFER_LENGTH, sizeof(data_t)) != RC_SPSC_OK)
+    {
+        printf("\nError - buffer length must be a power of two.\n");
+        return 1;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pthread_create(&consumer_thread, NULL, consumer, &errors);
+    pthread_create(&producer_thread, NULL, producer, NULL);
+    pthread_join(producer_thread, NULL);
+    pthread_join(consumer_thread, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+
+    double seconds = (stop.tv_sec - start.tv_sec) + ((stop.tv_nsec - start.tv_nsec) / 1e9);
+    printf("Moved %d elements in %.3f s (%.1f million pairs/s), %ld out of order\n",
+           TRANSFER_COUNT, seconds, (TRANSFER_COUNT / seconds) / 1e6, errors);
+
+    /* Blocking run with idle gaps */
+    double cpu_seconds = 0.0;
+    (void) fifo_spsc_init(&fifo_spsc_ctrl, data, BUFFER_LENGTH, sizeof(data_t));
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pthread_create(&consumer_thread, NULL, blocking_consumer, &cpu_seconds);
+    pthread_create(&producer_thread, NULL, burst_producer, NULL);
+    pthread_join(producer_thread, NULL);
+    pthread_join(consumer_thread, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+
+    seconds = (stop.tv_sec - start.tv_sec) + ((stop.tv_nsec - start.tv_nsec) / 1e9);
+    printf("Blocking run: %d bursts in %.3f s, consumer used %.3f s of CPU\n", BURST_COUNT, seconds, cpu_seconds);
+
+    /* Shared memory run between two processes */
+    fifo_spsc_rc_t rc;
+    fifo_spsc_shm_unlink(SHM_NAME);
+    fifo_spsc_t *shared = fifo_spsc_shm_create(SHM_NAME, BUFFER_LENGTH, sizeof(data_t), &rc);
+    if (shared != NULL)
+    {
+        int status = 1;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        pid_t child = fork();
+        if (child == 0)
+        {
+            _exit(shm_consumer());
+        }
+        for (int i = 0; i < SHM_TRANSFER_COUNT; i++)
+        {
+            data_t element = { .data_1 = i, .data_2 = -i };
+            (void) fifo_spsc_add_wait(shared, &element, SPSC_WAIT_FOREVER);
+        }
+        (void) waitpid(child, &status, 0);
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+
+        seconds = (stop.tv_sec - start.tv_sec) + ((stop.tv_nsec - start.tv_nsec) / 1e9);
+        printf("Shared memory run: %.1f million elements/s between processes, %s\n", (SHM_TRANSFER_COUNT / seconds) / 1e6,
+               (WIFEXITED(status) && (WEXITSTATUS(status) == 0)) ? "all in order" : "ERROR");
+        fifo_spsc_shm_detach(shared);
+        fifo_spsc_shm_unlink(SHM_NAME);
+    }
+    else
+    {
+        printf("\nError - could not create shared memory segment %s.\n", SHM_NAME);
+    }
+
+    /* De-initialize the buffer */
+    fifo_spsc_deInit(&fifo_spsc_ctrl);
+    printf("\nExited program");
+    return 0;
+}
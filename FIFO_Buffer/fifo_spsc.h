@@ -0,0 +1,544 @@
+/* A lock-free single-producer/single-consumer (SPSC) variant of the circular FIFO buffer
+    Exactly one thread may add (the producer) and exactly one thread may remove (the consumer).
+
+    Differences from fifo_buf.c:
+    - There is no shared count. Head and tail are free-running indices and the number of
+      elements is always (tail - head), so each side only ever writes its own index.
+    - The head (consumer owned) and the tail (producer owned) live on separate cache lines,
+      so the two cores never write to the same line (no false sharing).
+    - The length must be a power of two, so wrapping an index is a mask instead of a compare.
+    - The buffer is never overwritten; an add on a full buffer returns RC_SPSC_ERR_FULL,
+      as the producer cannot move the head without racing the consumer.
+
+    Producer:  write the element at tail, then publish tail + 1 (release store)
+    Consumer:  read tail (acquire load), read the element at head, then publish head + 1 (release store)
+
+     ______
+    |______|
+    |_DATA_| <- TAIL - 1          Count = TAIL - HEAD
+    |_DATA_|                      Slot  = index & (LENGTH - 1)
+    |_DATA_| <- HEAD
+
+    Blocking (Linux): fifo_spsc_remove_wait and fifo_spsc_add_wait spin for a short while, then sleep
+    on a futex on the index the other side moves. Before sleeping a side raises its waiting flag, and
+    the other side only makes the wake system call when it sees the flag raised, so a busy buffer
+    never enters the kernel. Threads that use the non-blocking add or remove call fifo_spsc_wake_consumer
+    or fifo_spsc_wake_producer once per batch instead of once per element.
+
+    Shared memory (Linux): fifo_spsc_shm_create puts the buffer and its ring in a named POSIX shared
+    memory segment and fifo_spsc_shm_attach maps it in any other process. The control block holds no
+    pointers, only indices and the offset of the ring from the control block itself, so it works at
+    whatever address each process maps it. Once attached, elements move without any system call.
+
+     _____________ ___________________________
+    |_fifo_spsc_t_|_________RING DATA_________|   Ring = (unsigned char *)fifo + data_offset
+*/
+#ifndef FIFO_SPSC_H
+#define FIFO_SPSC_H
+
+/* syscall is not part of ISO C */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+/* Standard libarary includes */
+#include <stddef.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#endif
+
+/* Size of a cache line, used to keep the producer and consumer indices apart */
+#define SPSC_CACHE_LINE         64
+
+/* Number of attempts a blocking call makes before it sleeps */
+#define SPSC_SPIN_COUNT         1000
+
+/* Timeout that makes a blocking call wait forever */
+#define SPSC_WAIT_FOREVER       (-1)
+
+/* Marks a shared memory segment that holds an initialized buffer */
+#define SPSC_SHM_MAGIC          0x43535053u
+
+/* Time between two tries of fifo_spsc_shm_attach while the segment is not ready */
+#define SPSC_SHM_RETRY_MS       1
+
+/* Indices shared between processes must not need a lock */
+_Static_assert(ATOMIC_INT_LOCK_FREE == 2, "atomic_uint must be lock-free to be shared between processes");
+
+/* SPSC FIFO buffer structure declaration */
+typedef struct
+{
+    /* Consumer side: the head index and the consumer's last seen copy of the tail */
+    _Alignas(SPSC_CACHE_LINE) atomic_uint head;
+    unsigned int tail_cache;
+
+    /* Producer side: the tail index and the producer's last seen copy of the head */
+    _Alignas(SPSC_CACHE_LINE) atomic_uint tail;
+    unsigned int head_cache;
+
+    /* Waiting flags, only written when a side goes to sleep or is woken */
+    _Alignas(SPSC_CACHE_LINE) atomic_uint consumer_waiting;
+    atomic_uint producer_waiting;
+
+    /* Read only after initialization */
+    _Alignas(SPSC_CACHE_LINE) unsigned int length;
+    unsigned int mask;
+    size_t elem_size;
+    /* Distance from this control block to the ring, so the block can be mapped at any address */
+    uintptr_t data_offset;
+    /* Set for a buffer in shared memory, which needs futexes visible to other processes */
+    bool shared;
+    size_t map_size;
+    atomic_uint magic;
+} fifo_spsc_t;
+
+/* SPSC FIFO buffer return code */
+typedef enum
+{
+    RC_SPSC_OK,
+    RC_SPSC_ERR_EMPTY,
+    RC_SPSC_ERR_FULL,
+    RC_SPSC_ERR_LENGTH,
+    RC_SPSC_ERR_TIMEOUT,
+    RC_SPSC_ERR_SHM,
+} fifo_spsc_rc_t;
+
+/* Function to get the address of the slot an index maps to */
+static inline unsigned char *fifo_spsc_slot (fifo_spsc_t *fifo, unsigned int index)
+{
+    /* The length is a power of two, so the wrap is a mask */
+    return (unsigned char *)((uintptr_t)fifo + fifo->data_offset) + ((size_t)(index & fifo->mask) * fifo->elem_size);
+}
+
+/* Funtion to add an element into the SPSC FIFO buffer, called only by the producer */
+static inline fifo_spsc_rc_t fifo_spsc_add (fifo_spsc_t *fifo, const void *element)
+{
+    fifo_spsc_rc_t rc = RC_SPSC_OK;
+    /* Only the producer writes the tail, so a relaxed load is enough */
+    unsigned int tail = atomic_load_explicit(&fifo->tail, memory_order_relaxed);
+
+    /* Check the cached head first, and only refresh it from the consumer's line when it looks full */
+    if ((tail - fifo->head_cache) == fifo->length)
+    {
+        fifo->head_cache = atomic_load_explicit(&fifo->head, memory_order_acquire);
+        if ((tail - fifo->head_cache) == fifo->length)
+        {
+            rc = RC_SPSC_ERR_FULL;
+        }
+    }
+
+    if (rc == RC_SPSC_OK)
+    {
+        /* Copy the element into the slot, then publish it to the consumer */
+        (void) memcpy ((void *)fifo_spsc_slot(fifo, tail), element, fifo->elem_size);
+        atomic_store_explicit(&fifo->tail, tail + 1u, memory_order_release);
+    }
+    return rc;
+}
+
+/* Function to remove an element from the SPSC FIFO buffer, called only by the consumer */
+static inline fifo_spsc_rc_t fifo_spsc_remove (fifo_spsc_t *fifo, void *element)
+{
+    fifo_spsc_rc_t rc = RC_SPSC_OK;
+    /* Only the consumer writes the head, so a relaxed load is enough */
+    unsigned int head = atomic_load_explicit(&fifo->head, memory_order_relaxed);
+
+    /* Check the cached tail first, and only refresh it from the producer's line when it looks empty */
+    if (head == fifo->tail_cache)
+    {
+        fifo->tail_cache = atomic_load_explicit(&fifo->tail, memory_order_acquire);
+        if (head == fifo->tail_cache)
+        {
+            rc = RC_SPSC_ERR_EMPTY;
+        }
+    }
+
+    if (rc == RC_SPSC_OK)
+    {
+        /* Copy the element out of the slot, then hand the slot back to the producer */
+        (void) memcpy (element, (void *)fifo_spsc_slot(fifo, head), fifo->elem_size);
+        atomic_store_explicit(&fifo->head, head + 1u, memory_order_release);
+    }
+    return rc;
+}
+
+/* Function to check if the SPSC FIFO buffer is empty, exact only when called by producer or consumer */
+static inline fifo_spsc_rc_t fifo_spsc_is_bufEmpty (fifo_spsc_t *fifo)
+{
+    fifo_spsc_rc_t rc = RC_SPSC_OK;
+
+    /* Both indices are equal when there is nothing between them */
+    if (atomic_load_explicit(&fifo->head, memory_order_acquire) ==
+        atomic_load_explicit(&fifo->tail, memory_order_acquire))
+    {
+        rc = RC_SPSC_ERR_EMPTY;
+    }
+    return rc;
+}
+
+#ifdef __linux__
+/* Function to let the core know the thread is spinning */
+static inline void fifo_spsc_cpu_relax (void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+/* Function to get the futex operation, only a buffer in shared memory needs other processes to see it */
+static inline int fifo_spsc_futex_op (fifo_spsc_t *fifo, int op)
+{
+    return fifo->shared ? op : (op | FUTEX_PRIVATE_FLAG);
+}
+
+/* Function to sleep while an index still holds the expected value, or until the deadline passes */
+static inline fifo_spsc_rc_t fifo_spsc_futex_wait (fifo_spsc_t *fifo, atomic_uint *index, unsigned int expected,
+                                                   const struct timespec *deadline)
+{
+    fifo_spsc_rc_t rc = RC_SPSC_OK;
+    struct timespec now, timeout, *timeout_ptr = NULL;
+
+    if (deadline != NULL)
+    {
+        /* The futex takes a relative timeout, so work out what is left */
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        timeout.tv_sec = deadline->tv_sec - now.tv_sec;
+        timeout.tv_nsec = deadline->tv_nsec - now.tv_nsec;
+        if (timeout.tv_nsec < 0)
+        {
+            timeout.tv_sec--;
+            timeout.tv_nsec += 1000000000L;
+        }
+        if (timeout.tv_sec < 0)
+        {
+            rc = RC_SPSC_ERR_TIMEOUT;
+        }
+        timeout_ptr = &timeout;
+    }
+
+    if (rc == RC_SPSC_OK)
+    {
+        /* Returns at once if the index has already moved away from the expected value */
+        (void) syscall(SYS_futex, (unsigned int *)index, fifo_spsc_futex_op(fifo, FUTEX_WAIT), expected, timeout_ptr, NULL, 0);
+    }
+    return rc;
+}
+
+/* Function to wake the consumer if it is sleeping, called by the producer after adding a batch */
+static inline void fifo_spsc_wake_consumer (fifo_spsc_t *fifo)
+{
+    /* Order the tail already published before the flag is read, pairs with the fence in the consumer */
+    atomic_thread_fence(memory_order_seq_cst);
+    if ((atomic_load_explicit(&fifo->consumer_waiting, memory_order_relaxed) != 0u) &&
+        (atomic_exchange_explicit(&fifo->consumer_waiting, 0u, memory_order_relaxed) != 0u))
+    {
+        (void) syscall(SYS_futex, (unsigned int *)&fifo->tail, fifo_spsc_futex_op(fifo, FUTEX_WAKE), 1, NULL, NULL, 0);
+    }
+}
+
+/* Function to wake the producer if it is sleeping, called by the consumer after removing a batch */
+static inline void fifo_spsc_wake_producer (fifo_spsc_t *fifo)
+{
+    /* Order the head already published before the flag is read, pairs with the fence in the producer */
+    atomic_thread_fence(memory_order_seq_cst);
+    if ((atomic_load_explicit(&fifo->producer_waiting, memory_order_relaxed) != 0u) &&
+        (atomic_exchange_explicit(&fifo->producer_waiting, 0u, memory_order_relaxed) != 0u))
+    {
+        (void) syscall(SYS_futex, (unsigned int *)&fifo->head, fifo_spsc_futex_op(fifo, FUTEX_WAKE), 1, NULL, NULL, 0);
+    }
+}
+
+/* Function to work out the deadline of a timeout in milliseconds, returns NULL to wait forever */
+static inline struct timespec *fifo_spsc_deadline (int timeout_ms, struct timespec *deadline)
+{
+    struct timespec *result = NULL;
+
+    if (timeout_ms != SPSC_WAIT_FOREVER)
+    {
+        clock_gettime(CLOCK_MONOTONIC, deadline);
+        deadline->tv_sec += timeout_ms / 1000;
+        deadline->tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+        if (deadline->tv_nsec >= 1000000000L)
+        {
+            deadline->tv_sec++;
+            deadline->tv_nsec -= 1000000000L;
+        }
+        result = deadline;
+    }
+    return result;
+}
+
+/* Function to remove an element, waiting up to timeout_ms (or SPSC_WAIT_FOREVER) while the buffer is empty */
+static inline fifo_spsc_rc_t fifo_spsc_remove_wait (fifo_spsc_t *fifo, void *element, int timeout_ms)
+{
+    struct timespec deadline_storage;
+    struct timespec *deadline = fifo_spsc_deadline(timeout_ms, &deadline_storage);
+    fifo_spsc_rc_t rc = RC_SPSC_ERR_EMPTY;
+
+    while (rc == RC_SPSC_ERR_EMPTY)
+    {
+        /* Spin for a while, the producer is usually close behind */
+        for (int i = 0; (i < SPSC_SPIN_COUNT) && (rc == RC_SPSC_ERR_EMPTY); i++)
+        {
+            rc = fifo_spsc_remove(fifo, element);
+            if (rc == RC_SPSC_ERR_EMPTY)
+            {
+                fifo_spsc_cpu_relax();
+            }
+        }
+
+        if (rc == RC_SPSC_ERR_EMPTY)
+        {
+            /* Raise the flag before the last look, so a producer adding now is sure to see it */
+            unsigned int head = atomic_load_explicit(&fifo->head, memory_order_relaxed);
+            atomic_store_explicit(&fifo->consumer_waiting, 1u, memory_order_relaxed);
+            atomic_thread_fence(memory_order_seq_cst);
+
+            rc = fifo_spsc_remove(fifo, element);
+            if (rc == RC_SPSC_ERR_EMPTY)
+            {
+                /* Sleep while the tail is still at the head, that is while the buffer is empty */
+                if (fifo_spsc_futex_wait(fifo, &fifo->tail, head, deadline) == RC_SPSC_ERR_TIMEOUT)
+                {
+                    rc = RC_SPSC_ERR_TIMEOUT;
+                }
+            }
+            atomic_store_explicit(&fifo->consumer_waiting, 0u, memory_order_relaxed);
+        }
+    }
+
+    if (rc == RC_SPSC_OK)
+    {
+        /* A slot was freed, let a sleeping producer know */
+        fifo_spsc_wake_producer(fifo);
+    }
+    return rc;
+}
+
+/* Funtion to add an element, waiting up to timeout_ms (or SPSC_WAIT_FOREVER) while the buffer is full */
+static inline fifo_spsc_rc_t fifo_spsc_add_wait (fifo_spsc_t *fifo, const void *element, int timeout_ms)
+{
+    struct timespec deadline_storage;
+    struct timespec *deadline = fifo_spsc_deadline(timeout_ms, &deadline_storage);
+    fifo_spsc_rc_t rc = RC_SPSC_ERR_FULL;
+
+    while (rc == RC_SPSC_ERR_FULL)
+    {
+        /* Spin for a while, the consumer is usually close behind */
+        for (int i = 0; (i < SPSC_SPIN_COUNT) && (rc == RC_SPSC_ERR_FULL); i++)
+        {
+            rc = fifo_spsc_add(fifo, element);
+            if (rc == RC_SPSC_ERR_FULL)
+            {
+                fifo_spsc_cpu_relax();
+            }
+        }
+
+        if (rc == RC_SPSC_ERR_FULL)
+        {
+            /* Raise the flag before the last look, so a consumer removing now is sure to see it */
+            unsigned int tail = atomic_load_explicit(&fifo->tail, memory_order_relaxed);
+            atomic_store_explicit(&fifo->producer_waiting, 1u, memory_order_relaxed);
+            atomic_thread_fence(memory_order_seq_cst);
+
+            rc = fifo_spsc_add(fifo, element);
+            if (rc == RC_SPSC_ERR_FULL)
+            {
+                /* Sleep while the head is still one lap behind the tail, that is while the buffer is full */
+                if (fifo_spsc_futex_wait(fifo, &fifo->head, tail - fifo->length, deadline) == RC_SPSC_ERR_TIMEOUT)
+                {
+                    rc = RC_SPSC_ERR_TIMEOUT;
+                }
+            }
+            atomic_store_explicit(&fifo->producer_waiting, 0u, memory_order_relaxed);
+        }
+    }
+
+    if (rc == RC_SPSC_OK)
+    {
+        /* An element was added, let a sleeping consumer know */
+        fifo_spsc_wake_consumer(fifo);
+    }
+    return rc;
+}
+#endif /* __linux__ */
+
+/* Initialize the SPSC FIFO buffer over caller supplied storage of length elements
+    The ring is found from the address of the control block, so the block must not be copied or moved.
+*/
+static inline fifo_spsc_rc_t fifo_spsc_init (fifo_spsc_t *fifo, void *storage, unsigned int length, size_t elem_size)
+{
+    fifo_spsc_rc_t rc = RC_SPSC_OK;
+
+    /* The length must be a non-zero power of two for the index mask to work */
+    if ((length == 0u) || ((length & (length - 1u)) != 0u))
+    {
+        rc = RC_SPSC_ERR_LENGTH;
+    }
+    else
+    {
+        /* Set the buffer size and the wrap mask */
+        fifo->length = length;
+        fifo->mask = length - 1u;
+        fifo->elem_size = elem_size;
+        /* Keep the caller's storage as a distance from the control block */
+        fifo->data_offset = (uintptr_t)storage - (uintptr_t)fifo;
+        fifo->shared = false;
+        fifo->map_size = 0u;
+        atomic_init(&fifo->magic, 0u);
+        /* Both indices start at zero as the buffer is empty */
+        atomic_init(&fifo->head, 0u);
+        atomic_init(&fifo->tail, 0u);
+        fifo->head_cache = fifo->tail_cache = 0u;
+        /* Nobody is sleeping */
+        atomic_init(&fifo->consumer_waiting, 0u);
+        atomic_init(&fifo->producer_waiting, 0u);
+    }
+    return rc;
+}
+
+/* De-Initialize the SPSC FIFO buffer */
+static inline void fifo_spsc_deInit (fifo_spsc_t *fifo)
+{
+    /* Set the buffer size */
+    fifo->length = fifo->mask = 0u;
+    /* Forget the storage */
+    fifo->data_offset = 0u;
+    /* Reset both the indices */
+    atomic_store(&fifo->head, 0u);
+    atomic_store(&fifo->tail, 0u);
+    fifo->head_cache = fifo->tail_cache = 0u;
+}
+
+#ifdef __linux__
+/* Function to create a named shared memory segment holding a new SPSC FIFO buffer
+    Returns the buffer mapped in this process, or NULL with the reason in rc. The name follows
+    shm_open, such as "/my_queue", and must not exist yet.
+*/
+static inline fifo_spsc_t *fifo_spsc_shm_create (const char *name, unsigned int length, size_t elem_size, fifo_spsc_rc_t *rc)
+{
+    fifo_spsc_t *fifo = NULL;
+    /* The ring starts right after the control block, which is a whole number of cache lines */
+    size_t size = sizeof(fifo_spsc_t) + ((size_t)length * elem_size);
+
+    *rc = RC_SPSC_ERR_SHM;
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0)
+    {
+        void *area = MAP_FAILED;
+        if (ftruncate(fd, (off_t)size) == 0)
+        {
+            area = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+
+        if (area != MAP_FAILED)
+        {
+            fifo = (fifo_spsc_t *)area;
+            *rc = fifo_spsc_init(fifo, (unsigned char *)area + sizeof(fifo_spsc_t), length, elem_size);
+            if (*rc == RC_SPSC_OK)
+            {
+                fifo->shared = true;
+                fifo->map_size = size;
+                /* Publish the magic last, fifo_spsc_shm_attach waits for it before using the buffer */
+                atomic_store_explicit(&fifo->magic, SPSC_SHM_MAGIC, memory_order_release);
+            }
+            else
+            {
+                (void) munmap(area, size);
+                fifo = NULL;
+            }
+        }
+
+        if (fifo == NULL)
+        {
+            (void) shm_unlink(name);
+        }
+        /* The mapping keeps the segment open */
+        (void) close(fd);
+    }
+    return fifo;
+}
+
+/* Function to try once to map an SPSC FIFO buffer created by another process, returns NULL if it is not ready */
+static inline fifo_spsc_t *fifo_spsc_shm_try_attach (const char *name)
+{
+    fifo_spsc_t *fifo = NULL;
+    struct stat segment_stat;
+
+    int fd = shm_open(name, O_RDWR, 0600);
+    if ((fd >= 0) && (fstat(fd, &segment_stat) == 0) && ((size_t)segment_stat.st_size >= sizeof(fifo_spsc_t)))
+    {
+        void *area = mmap(NULL, (size_t)segment_stat.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (area != MAP_FAILED)
+        {
+            fifo = (fifo_spsc_t *)area;
+            /* The creator may still be initializing, and the segment must be the size it says it is */
+            if ((atomic_load_explicit(&fifo->magic, memory_order_acquire) != SPSC_SHM_MAGIC) ||
+                (fifo->map_size != (size_t)segment_stat.st_size))
+            {
+                (void) munmap(area, (size_t)segment_stat.st_size);
+                fifo = NULL;
+            }
+        }
+    }
+    if (fd >= 0)
+    {
+        (void) close(fd);
+    }
+    return fifo;
+}
+
+/* Function to map an SPSC FIFO buffer created by another process with fifo_spsc_shm_create
+    Waits up to timeout_ms (or SPSC_WAIT_FOREVER) for the segment to exist and its creator to publish
+    the magic, trying again every SPSC_SHM_RETRY_MS. A timeout of 0 tries once. Returns the buffer
+    mapped in this process, or NULL with RC_SPSC_ERR_TIMEOUT (RC_SPSC_ERR_SHM when not waiting) in rc.
+*/
+static inline fifo_spsc_t *fifo_spsc_shm_attach (const char *name, int timeout_ms, fifo_spsc_rc_t *rc)
+{
+    struct timespec deadline_storage, now;
+    struct timespec *deadline = fifo_spsc_deadline(timeout_ms, &deadline_storage);
+    const struct timespec retry = { 0, SPSC_SHM_RETRY_MS * 1000000L };
+    fifo_spsc_t *fifo = fifo_spsc_shm_try_attach(name);
+    bool waiting = (timeout_ms != 0);
+
+    while ((fifo == NULL) && waiting)
+    {
+        (void) nanosleep(&retry, NULL);
+        fifo = fifo_spsc_shm_try_attach(name);
+        if (deadline != NULL)
+        {
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            waiting = (now.tv_sec < deadline->tv_sec) ||
+                      ((now.tv_sec == deadline->tv_sec) && (now.tv_nsec < deadline->tv_nsec));
+        }
+    }
+    *rc = (fifo != NULL) ? RC_SPSC_OK : ((timeout_ms != 0) ? RC_SPSC_ERR_TIMEOUT : RC_SPSC_ERR_SHM);
+    return fifo;
+}
+
+/* Function to unmap a shared SPSC FIFO buffer from this process, the segment stays until unlinked */
+static inline void fifo_spsc_shm_detach (fifo_spsc_t *fifo)
+{
+    (void) munmap((void *)fifo, fifo->map_size);
+}
+
+/* Function to remove the name of a shared memory segment, it is freed once every process detached */
+static inline void fifo_spsc_shm_unlink (const char *name)
+{
+    (void) shm_unlink(name);
+}
+#endif /* __linux__ */
+
+#endif /* FIFO_SPSC_H */
@@ -1,20 +1,15 @@
-/* A basic implementation of LIFO buffer */
-#include <stdio.h>
-#include <string.h>
+/* Demonstration of the LIFO buffer in lifo_buf.h
+    Elements are pushed and popped at the head of one buffer instance over a static array.
+*/
 
-/* Buffer size */
-#define BUFFER_LENGTH           4
+/* The counters of -DBUF_STATS and the trace of -DBUF_TRACE are defined in this file */
+#define BUF_STATS_IMPLEMENTATION
+#define BUF_TRACE_IMPLEMENTATION
 
-/* Basic LIFO buffer implementation: 
-    Empty state,  One element added,     Two more elements added, One element removed,  Buffer Full
-     ______          ______                   ______                 ______              ______   
-    |______|        |______|                 |______|               |______|            |_DATA_| <- HEAD
-    |______|        |______|                 |_DATA_| <- HEAD       |______|            |_DATA_|
-    |______|        |______|                 |_DATA_|               |_DATA_| <- HEAD    |_DATA_|
-    |______|        |_DATA_| <- HEAD,BASE    |_DATA_| <- BASE       |_DATA_| <- BASE    |_DATA_| <- BASE
-
-*/
+#include "lifo_buf.h"
 
+/* Buffer size */
+#define BUFFER_LENGTH           4
 
 /* The data organized in structure */
 typedef struct 
@@ -26,129 +21,16 @@ typedef struct
 /* Static allocation of data is preferred */
 data_t data[BUFFER_LENGTH];
 
-/* LIFO buffer structure declaration */
-typedef struct 
-{
-    int length;
-    data_t *base;
-    data_t *head;
-} lifo_buf_t;
-
 lifo_buf_t lifo_buf_ctrl;
 
-/* LIFO buffer return code */
-typedef enum 
-{
-    RC_LBUF_OK,
-    RC_LBUF_ERR_FULL,
-    RC_LBUF_ERR_EMPTY,
-} lifo_rc_t;
+/* LIFO functions specialized for data_t: data_lifo_push, data_lifo_pop */
+LIFO_BUF_DEFINE(data_lifo, data_t)
 
-void debug_lifo_pointer(void)
+/* Function to print an element while traversing */
+void print_element (int element_number, void *element)
 {
-    printf("\nHead: %d\n", lifo_buf_ctrl.head - lifo_buf_ctrl.base);
-}
-
-/* Function to check if the LIFO buffer is empty */
-lifo_rc_t lifo_is_bufEmpty (void)
-{
-    lifo_rc_t rc = RC_LBUF_OK;
-
-    /* If the head is pointing to base, then the buffer is empty */
-    if (lifo_buf_ctrl.head == lifo_buf_ctrl.base) 
-    {
-        rc = RC_LBUF_ERR_EMPTY;
-    }
-    return rc;
-}
-
-/* Function to check if the LIFO buffer is full */
-lifo_rc_t lifo_is_bufFull (void)
-{
-    lifo_rc_t rc = RC_LBUF_OK;
-
-    /* If the head is greater than or equal to the base + length then buffer is full */
-    if (lifo_buf_ctrl.head >= (lifo_buf_ctrl.base + lifo_buf_ctrl.length)) 
-    {
-        rc = RC_LBUF_ERR_FULL;
-    }
-    return rc;
-}
-
-/* Funtion to push an element into the LIFO buffer */
-lifo_rc_t lifo_push (data_t *element)
-{
-    /* Check if the buffer is full */
-    lifo_rc_t rc = lifo_is_bufFull();
-
-    if (rc == RC_LBUF_OK) 
-    {
-        /* Buffer is not full, then copy the element into the buffer */
-        (void) memset ((void *)lifo_buf_ctrl.head, 0u, sizeof(element));
-        (void) memcpy ((void *)lifo_buf_ctrl.head, (void *)element, sizeof(element));
-        /* Make the head point to the next element */
-        lifo_buf_ctrl.head++;
-    }
-    return rc;
-}
-
-/* Function to pop and element from the LIFO buffer */
-lifo_rc_t lifo_pop (data_t *element)
-{
-    /* Check if the buffer is empty */
-    lifo_rc_t rc = lifo_is_bufEmpty();
-
-    if (rc == RC_LBUF_OK) 
-    {
-        /* Buffer is not empty then remove the element from the buffer */
-        (void) memcpy ((void *)element, (void *)(lifo_buf_ctrl.head - 1), sizeof(element));
-        /* Make the head point to the previous element */
-        lifo_buf_ctrl.head--;
-    }
-    return rc;
-}
-
-lifo_rc_t lifo_traverse (void)
-{
-    /* Check if the buffer is empty */
-    lifo_rc_t rc = lifo_is_bufEmpty();
-
-    if (rc == RC_LBUF_OK) 
-    {
-        /* To count the number of elements */
-        int element_number = lifo_buf_ctrl.length;
-        /* Get the head pointer */
-        data_t *var = lifo_buf_ctrl.head; 
-        do
-        {
-            /* Traverse through the LIFO buffer till hitting the base */
-            var--;
-            printf ("Element %d: Data A: %d, Data B: %d\n", element_number--, var->data_1, var->data_2);
-        } while(var != lifo_buf_ctrl.base);
-    }
-    return rc;
-}
-
-/* Initialize the LIFO buffer */
-void lifo_init (void)
-{
-    /* Set the buffer size */
-    lifo_buf_ctrl.length = BUFFER_LENGTH;
-    /* Make the base of the buffer point to the 0th element of the array */
-    lifo_buf_ctrl.base = &data[0];
-    /* Make the head point to the base as the buffer is empty */
-    lifo_buf_ctrl.head = lifo_buf_ctrl.base;
-}
-
-/* De-Initialize the LIFO buffer */
-void lifo_deInit (void)
-{
-    /* Set the buffer size */
-    lifo_buf_ctrl.length = 0;
-    /* Make the base of the buffer point to NULL */
-    lifo_buf_ctrl.base = NULL;
-    /* Make the head point to the NULL */
-    lifo_buf_ctrl.head = NULL;
+    data_t *var = (data_t *)element;
+    printf ("Element %d: Data A: %d, Data B: %d\n", element_number, var->data_1, var->data_2);
 }
 
 int main()
@@ -159,7 +41,7 @@ int main()
     lifo_rc_t rc;
     
     /* Initialize the LIFO buffer */
-    lifo_init();
+    data_lifo_init(&lifo_buf_ctrl, data, BUFFER_LENGTH);
 
     /* 1 to push, 2 to pop, 3 to exit */
     while (symbol != '4')
@@ -176,8 +58,8 @@ int main()
                 scanf("%d", &element.data_1);
                 printf("Data B: ");
                 scanf("%d", &element.data_2);
-                rc = lifo_push(&element);
-                debug_lifo_pointer();
+                rc = data_lifo_push(&lifo_buf_ctrl, &element);
+                debug_lifo_pointer(&lifo_buf_ctrl);
 
                 if (rc == RC_LBUF_OK) 
                 {
@@ -192,8 +74,8 @@ int main()
             case '2':
             {
                 /* Pop if the buffer is not empty  */
-                rc = lifo_pop(&element);
-                debug_lifo_pointer();
+                rc = data_lifo_pop(&lifo_buf_ctrl, &element);
+                debug_lifo_pointer(&lifo_buf_ctrl);
 
                 if (rc == RC_LBUF_OK) 
                 {
@@ -209,7 +91,7 @@ int main()
             case '3':
             {
                 /* Traverse the LIFO buffer */
-                rc = lifo_traverse();
+                rc = lifo_traverse(&lifo_buf_ctrl, print_element);
                 
                 if (rc != RC_LBUF_OK)
                 {
@@ -226,8 +108,11 @@ int main()
         }
     }
 
+    /* Counters of the hot paths, when built with -DBUF_STATS */
+    buf_stats_print(BUF_STATS_LIFO);
+
     /* De-init the pointers */
-    lifo_deInit();
+    lifo_deInit(&lifo_buf_ctrl);
     printf("\nExited program");
     return 0;
 }
\ No newline at end of file
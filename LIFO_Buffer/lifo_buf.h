@@ -0,0 +1,243 @@
+/* A basic implementation of LIFO buffer
+
+    Basic LIFO buffer implementation:
+    Empty state,  One element added,     Two more elements added, One element removed,  Buffer Full
+     ______          ______                   ______                 ______              ______
+    |______|        |______|                 |______|               |______|            |_DATA_| <- HEAD
+    |______|        |______|                 |_DATA_| <- HEAD       |______|            |_DATA_|
+    |______|        |______|                 |_DATA_|               |_DATA_| <- HEAD    |_DATA_|
+    |______|        |_DATA_| <- HEAD,BASE    |_DATA_| <- BASE       |_DATA_| <- BASE    |_DATA_| <- BASE
+
+    Every buffer is an instance of lifo_buf_t over storage supplied by the caller, so any number of
+    buffers with different element types and lengths can exist at the same time. The head is the
+    index of the next free element, which is also the number of elements in the buffer.
+
+    The functions work on elements of any size. LIFO_BUF_DEFINE(name, type) generates functions
+    for one element type (name_push, name_pop, ...) that move elements by assignment, so the
+    compiler copies a fixed size inline instead of calling memcpy.
+*/
+#ifndef LIFO_BUF_H
+#define LIFO_BUF_H
+
+/* Standard libarary includes */
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+
+/* Counters and capture of the hot paths, compiled in with -DBUF_STATS and -DBUF_TRACE */
+#include "../Common/buf_stats.h"
+#include "../Common/buf_trace.h"
+
+/* LIFO buffer structure declaration */
+typedef struct
+{
+    int length;
+    int head;
+    size_t elem_size;
+    unsigned char *base;
+} lifo_buf_t;
+
+/* LIFO buffer return code */
+typedef enum
+{
+    RC_LBUF_OK,
+    RC_LBUF_ERR_FULL,
+    RC_LBUF_ERR_EMPTY,
+} lifo_rc_t;
+
+/* Function called by lifo_traverse for every element, newest first */
+typedef void (*lifo_visit_t) (int element_number, void *element);
+
+static inline void debug_lifo_pointer (lifo_buf_t *lifo)
+{
+    printf("\nHead: %d\n", lifo->head);
+}
+
+/* Function to get the address of the element at an index */
+static inline void *lifo_slot (lifo_buf_t *lifo, int index)
+{
+    return (void *)(lifo->base + ((size_t)index * lifo->elem_size));
+}
+
+/* Function to check if the LIFO buffer is empty */
+static inline lifo_rc_t lifo_is_bufEmpty (lifo_buf_t *lifo)
+{
+    lifo_rc_t rc = RC_LBUF_OK;
+
+    /* If the head is pointing to base, then the buffer is empty */
+    if (lifo->head == 0)
+    {
+        rc = RC_LBUF_ERR_EMPTY;
+    }
+    return rc;
+}
+
+/* Function to check if the LIFO buffer is full */
+static inline lifo_rc_t lifo_is_bufFull (lifo_buf_t *lifo)
+{
+    lifo_rc_t rc = RC_LBUF_OK;
+
+    /* If the head is greater than or equal to the length then buffer is full */
+    if (lifo->head >= lifo->length)
+    {
+        rc = RC_LBUF_ERR_FULL;
+    }
+    return rc;
+}
+
+/* Function to take the slot above the head, returns the slot the element must be written to or NULL if full */
+static inline void *lifo_push_slot (lifo_buf_t *lifo)
+{
+    void *slot = NULL;
+    BUF_STAT_ADD(BUF_STATS_LIFO, BUF_STAT_OPS, 1u);
+
+    if (lifo_is_bufFull(lifo) == RC_LBUF_OK)
+    {
+        slot = lifo_slot(lifo, lifo->head);
+        /* Make the head point to the next element */
+        lifo->head++;
+    }
+    else
+    {
+        BUF_STAT_ADD(BUF_STATS_LIFO, BUF_STAT_FULL, 1u);
+    }
+    return slot;
+}
+
+/* Function to take the element below the head, returns its slot or NULL if empty
+    The slot stays valid until the next element is pushed.
+*/
+static inline void *lifo_pop_slot (lifo_buf_t *lifo)
+{
+    void *slot = NULL;
+    BUF_STAT_ADD(BUF_STATS_LIFO, BUF_STAT_OPS, 1u);
+
+    if (lifo_is_bufEmpty(lifo) == RC_LBUF_OK)
+    {
+        /* Make the head point to the previous element */
+        lifo->head--;
+        slot = lifo_slot(lifo, lifo->head);
+    }
+    else
+    {
+        BUF_STAT_ADD(BUF_STATS_LIFO, BUF_STAT_EMPTY, 1u);
+    }
+    return slot;
+}
+
+/* Funtion to push an element into the LIFO buffer */
+static inline lifo_rc_t lifo_push (lifo_buf_t *lifo, const void *element)
+{
+    BUF_STAT_START(start);
+    lifo_rc_t rc = RC_LBUF_ERR_FULL;
+    void *slot = lifo_push_slot(lifo);
+
+    if (slot != NULL)
+    {
+        /* Buffer is not full, then copy the element into the buffer */
+        (void) memcpy (slot, element, lifo->elem_size);
+        rc = RC_LBUF_OK;
+    }
+    BUF_STAT_STOP(BUF_STATS_LIFO, start);
+    BUF_TRACE_OP(BUF_STATS_LIFO, BUF_TRACE_ADD, 0, (rc != RC_LBUF_OK));
+    return rc;
+}
+
+/* Function to pop and element from the LIFO buffer */
+static inline lifo_rc_t lifo_pop (lifo_buf_t *lifo, void *element)
+{
+    BUF_STAT_START(start);
+    lifo_rc_t rc = RC_LBUF_ERR_EMPTY;
+    void *slot = lifo_pop_slot(lifo);
+
+    if (slot != NULL)
+    {
+        /* Buffer is not empty then remove the element from the buffer */
+        (void) memcpy (element, slot, lifo->elem_size);
+        rc = RC_LBUF_OK;
+    }
+    BUF_STAT_STOP(BUF_STATS_LIFO, start);
+    BUF_TRACE_OP(BUF_STATS_LIFO, BUF_TRACE_REMOVE, 0, (rc != RC_LBUF_OK));
+    return rc;
+}
+
+static inline lifo_rc_t lifo_traverse (lifo_buf_t *lifo, lifo_visit_t visit)
+{
+    /* Check if the buffer is empty */
+    lifo_rc_t rc = lifo_is_bufEmpty(lifo);
+
+    if (rc == RC_LBUF_OK)
+    {
+        /* Get the head index */
+        int var = lifo->head;
+        do
+        {
+            /* Traverse through the LIFO buffer till hitting the base */
+            var--;
+            visit(var + 1, lifo_slot(lifo, var));
+        } while (var != 0);
+    }
+    return rc;
+}
+
+/* Initialize the LIFO buffer over caller supplied storage of length elements */
+static inline void lifo_init (lifo_buf_t *lifo, void *storage, int length, size_t elem_size)
+{
+    /* Set the buffer size */
+    lifo->length = length;
+    lifo->elem_size = elem_size;
+    /* Make the base of the buffer point to the 0th element of the storage */
+    lifo->base = (unsigned char *)storage;
+    /* Make the head point to the base as the buffer is empty */
+    lifo->head = 0;
+}
+
+/* De-Initialize the LIFO buffer */
+static inline void lifo_deInit (lifo_buf_t *lifo)
+{
+    /* Set the buffer size */
+    lifo->length = 0;
+    /* Make the base of the buffer point to NULL */
+    lifo->base = NULL;
+    /* Make the head point to the base */
+    lifo->head = 0;
+}
+
+/* Generate LIFO functions for one element type: name_init, name_push and name_pop
+    Elements are moved by assignment, so the copy is a fixed size move the compiler can inline.
+*/
+#define LIFO_BUF_DEFINE(name, type)                                                             \
+    static inline void name##_init (lifo_buf_t *lifo, type *storage, int length)               \
+    {                                                                                           \
+        lifo_init(lifo, (void *)storage, length, sizeof(type));                                 \
+    }                                                                                           \
+    static inline lifo_rc_t name##_push (lifo_buf_t *lifo, const type *element)                \
+    {                                                                                           \
+        BUF_STAT_START(start);                                                                  \
+        lifo_rc_t rc = RC_LBUF_ERR_FULL;                                                        \
+        type *slot = (type *)lifo_push_slot(lifo);                                              \
+        if (slot != NULL)                                                                       \
+        {                                                                                       \
+            *slot = *element;                                                                   \
+            rc = RC_LBUF_OK;                                                                    \
+        }                                                                                       \
+        BUF_STAT_STOP(BUF_STATS_LIFO, start);                                                   \
+        BUF_TRACE_OP(BUF_STATS_LIFO, BUF_TRACE_ADD, 0, (rc != RC_LBUF_OK));                     \
+        return rc;                                                                              \
+    }                                                                                           \
+    static inline lifo_rc_t name##_pop (lifo_buf_t *lifo, type *element)                       \
+    {                                                                                           \
+        BUF_STAT_START(start);                                                                  \
+        lifo_rc_t rc = RC_LBUF_ERR_EMPTY;                                                       \
+        type *slot = (type *)lifo_pop_slot(lifo);                                               \
+        if (slot != NULL)                                                                       \
+        {                                                                                       \
+            *element = *slot;                                                                   \
+            rc = RC_LBUF_OK;                                                                    \
+        }                                                                                       \
+        BUF_STAT_STOP(BUF_STATS_LIFO, start);                                                   \
+        BUF_TRACE_OP(BUF_STATS_LIFO, BUF_TRACE_REMOVE, 0, (rc != RC_LBUF_OK));                  \
+        return rc;                                                                              \
+    }
+
+#endif /* LIFO_BUF_H */
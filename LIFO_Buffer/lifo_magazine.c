@@ -0,0 +1,202 @@
+/* Demonstration of the object pool in lifo_magazine.h
+    Every thread repeatedly allocates a burst of records and frees them again, for 1, 2, 4 and 8
+    threads. The same work is run on a single LIFO buffer of free records behind a mutex, which all
+    the threads contend for, and on the pool with a magazine cache per thread.
+
+    Each thread writes its number into the records it holds and checks it before freeing them, so a
+    record handed to two threads at once is counted as an error, and so is a record that could not be
+    given back.
+*/
+
+/* Standard libarary includes */
+#include <stdio.h>
+#include <pthread.h>
+#include <time.h>
+
+/* The counters of -DBUF_STATS and the trace of -DBUF_TRACE are defined in this file */
+#define BUF_STATS_IMPLEMENTATION
+#define BUF_TRACE_IMPLEMENTATION
+
+#include "lifo_magazine.h"
+
+/* Number of preallocated records */
+#define RECORD_COUNT            4096
+
+/* Alloc/free pairs made on each run, shared between the threads */
+#define OPERATION_COUNT         8000000
+
+/* Records a thread holds before it frees them */
+#define BURST_LENGTH            16
+
+/* Largest number of threads */
+#define MAX_THREADS             8
+
+/* The data organized in structure */
+typedef struct
+{
+    int owner;
+    int data;
+} data_t;
+
+/* Static allocation of data is preferred */
+_Alignas(TREIBER_CACHE_LINE) unsigned char data[LIFO_MAG_STORAGE_SIZE(RECORD_COUNT, sizeof(data_t), MAX_THREADS)];
+
+lifo_mag_pool_t lifo_mag_pool_ctrl;
+
+/* The shared free list the pool is compared with */
+data_t records[RECORD_COUNT];
+lifo_mag_round_t free_list[RECORD_COUNT];
+lifo_buf_t lifo_buf_ctrl;
+pthread_mutex_t lifo_buf_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Work assigned to one thread */
+typedef struct
+{
+    int number;
+    int count;
+    int errors;
+} worker_t;
+
+/* Function to take a record from the shared free list */
+void *shared_alloc (void *context)
+{
+    lifo_mag_round_t record = NULL;
+
+    (void) context;
+    pthread_mutex_lock(&lifo_buf_lock);
+    (void) lifo_mag_round_pop(&lifo_buf_ctrl, &record);
+    pthread_mutex_unlock(&lifo_buf_lock);
+    return record;
+}
+
+/* Function to give a record back to the shared free list */
+lifo_rc_t shared_free (void *context, void *record)
+{
+    lifo_mag_round_t round = record;
+    lifo_rc_t rc;
+
+    (void) context;
+    pthread_mutex_lock(&lifo_buf_lock);
+    rc = lifo_mag_round_push(&lifo_buf_ctrl, &round);
+    pthread_mutex_unlock(&lifo_buf_lock);
+    return rc;
+}
+
+/* Function to take a record from the pool through the cache of the thread */
+void *pool_alloc (void *context)
+{
+    return lifo_mag_alloc((lifo_mag_cache_t *)context);
+}
+
+/* Function to give a record back to the pool through the cache of the thread */
+lifo_rc_t pool_free (void *context, void *record)
+{
+    return lifo_mag_free((lifo_mag_cache_t *)context, record);
+}
+
+/* Allocation functions used by the workers of the current run */
+void *(*run_alloc) (void *context);
+lifo_rc_t (*run_free) (void *context, void *record);
+
+/* Function to allocate and free bursts of records */
+void run_bursts (worker_t *work, void *context)
+{
+    data_t *held[BURST_LENGTH];
+
+    for (int i = 0; i < work->count; i += BURST_LENGTH)
+    {
+        for (int j = 0; j < BURST_LENGTH; j++)
+        {
+            held[j] = (data_t *)run_alloc(context);
+            held[j]->owner = work->number;
+            held[j]->data = i + j;
+        }
+        for (int j = 0; j < BURST_LENGTH; j++)
+        {
+            /* Another owner means the record was handed out twice */
+            if ((held[j]->owner != work->number) || (held[j]->data != (i + j)))
+            {
+                work->errors++;
+            }
+            /* A record that cannot be given back is lost to every thread */
+            if (run_free(context, held[j]) != RC_LBUF_OK)
+            {
+                work->errors++;
+            }
+        }
+    }
+}
+
+void *shared_worker (void *arg)
+{
+    run_bursts((worker_t *)arg, NULL);
+    return arg;
+}
+
+void *pool_worker (void *arg)
+{
+    lifo_mag_cache_t cache;
+
+    /* Each thread takes its own cache and hands its magazines back when done */
+    (void) lifo_mag_cache_init(&cache, &lifo_mag_pool_ctrl);
+    run_bursts((worker_t *)arg, &cache);
+    lifo_mag_cache_flush(&cache);
+    return arg;
+}
+
+/* Function to time one run, returns the number of errors */
+int timed_run (const char *name, void *(*worker) (void *), int thread_count)
+{
+    pthread_t threads[MAX_THREADS];
+    worker_t workers[MAX_THREADS];
+    struct timespec start, stop;
+    int errors = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < thread_count; i++)
+    {
+        workers[i] = (worker_t){ .number = i, .count = OPERATION_COUNT / thread_count, .errors = 0 };
+        pthread_create(&threads[i], NULL, worker, &workers[i]);
+    }
+    for (int i = 0; i < thread_count; i++)
+    {
+        pthread_join(threads[i], NULL);
+        errors += workers[i].errors;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+
+    double seconds = (stop.tv_sec - start.tv_sec) + ((stop.tv_nsec - start.tv_nsec) / 1e9);
+    printf("%d threads, %-17s %6.1f million alloc/free pairs/s, %d errors\n", thread_count, name,
+           (OPERATION_COUNT / seconds) / 1e6, errors);
+    return errors;
+}
+
+int main()
+{
+    printf("\nMagazine Object Pool Implementation. %d records, magazines of %d\n", RECORD_COUNT, LIFO_MAGAZINE_LENGTH);
+
+    for (int thread_count = 1; thread_count <= MAX_THREADS; thread_count *= 2)
+    {
+        /* Shared free list over the static records */
+        lifo_mag_round_init(&lifo_buf_ctrl, free_list, RECORD_COUNT);
+        for (int i = 0; i < RECORD_COUNT; i++)
+        {
+            lifo_mag_round_t round = &records[i];
+            (void) lifo_mag_round_push(&lifo_buf_ctrl, &round);
+        }
+        run_alloc = shared_alloc;
+        run_free = shared_free;
+        (void) timed_run("shared free list:", shared_worker, thread_count);
+        lifo_deInit(&lifo_buf_ctrl);
+
+        /* Object pool over the static storage */
+        lifo_mag_pool_init(&lifo_mag_pool_ctrl, data, RECORD_COUNT, sizeof(data_t), MAX_THREADS);
+        run_alloc = pool_alloc;
+        run_free = pool_free;
+        (void) timed_run("magazine pool:", pool_worker, thread_count);
+        lifo_mag_pool_deInit(&lifo_mag_pool_ctrl);
+    }
+
+    printf("\nExited program");
+    return 0;
+}
@@ -0,0 +1,275 @@
+/* An object pool for many threads built on LIFO buffers, with a per thread cache of magazines
+
+    The pool hands out fixed size objects preallocated in caller supplied storage. Free objects are
+    kept as pointers in magazines, each a small LIFO buffer of LIFO_MAGAZINE_LENGTH pointers. Every
+    thread owns a cache of two magazines (loaded and previous) that it pushes to and pops from without
+    any synchronization. Whole magazines are exchanged with a shared depot of two lock-free stacks.
+
+         Thread 1          Thread 2                      Depot
+     ______________    ______________          _______________________
+    | LOADED       |  | LOADED       |        | FULL       | EMPTY    |
+    | PREVIOUS     |  | PREVIOUS     | <----> | MAGAZINES  | MAGAZINES|
+    |______________|  |______________|        |____________|__________|
+
+    Alloc: pop from the loaded magazine. If it is empty, swap with the previous one if that has objects,
+           else hand the empty previous to the depot and load a full magazine from the depot.
+    Free:  push to the loaded magazine. If it is full, swap with the previous one if that has room,
+           else hand the full previous to the depot and load an empty magazine from the depot.
+
+    A thread only goes to the depot after at least LIFO_MAGAZINE_LENGTH operations on its own
+    magazines, so most allocations and frees touch only the cache lines of the thread's own magazines.
+
+    The full depot only ever takes full magazines, and the one partly filled magazine of the initial
+    load. When a thread flushes its cache, the objects of a partly filled magazine go one by one onto
+    a spill stack, another lock-free LIFO buffer with room for every object, and the magazine goes back
+    empty. The pool has enough magazines for every object plus three per thread, so a thread freeing
+    an object finds an empty magazine in the depot. Should the depot still run out, the object goes
+    onto the spill stack, and a thread finding no full magazine reloads its magazine from there.
+*/
+#ifndef LIFO_MAGAZINE_H
+#define LIFO_MAGAZINE_H
+
+/* Standard libarary includes */
+#include <stddef.h>
+
+/* Magazines are basic LIFO buffers, the depot is two lock-free LIFO buffers */
+#include "lifo_buf.h"
+#include "lifo_treiber.h"
+
+/* Number of object pointers held by a magazine */
+#ifndef LIFO_MAGAZINE_LENGTH
+#define LIFO_MAGAZINE_LENGTH    32
+#endif
+
+/* A free object, as held in a magazine */
+typedef void *lifo_mag_round_t;
+
+/* LIFO functions specialized for object pointers: lifo_mag_round_push, lifo_mag_round_pop */
+LIFO_BUF_DEFINE(lifo_mag_round, lifo_mag_round_t)
+
+/* Magazine structure declaration, on its own cache lines as it is only used by one thread at a time */
+typedef struct
+{
+    _Alignas(TREIBER_CACHE_LINE) lifo_buf_t rounds;
+    lifo_mag_round_t round[LIFO_MAGAZINE_LENGTH];
+} lifo_magazine_t;
+
+/* Function to round a size up to the alignment of any object */
+#define LIFO_MAG_ALIGN(size)    (((size) + (_Alignof(max_align_t) - 1u)) & ~(_Alignof(max_align_t) - 1u))
+
+/* Number of magazines needed for obj_count objects used by thread_count threads */
+#define LIFO_MAG_COUNT(obj_count, thread_count) \
+    ((((obj_count) + LIFO_MAGAZINE_LENGTH - 1) / LIFO_MAGAZINE_LENGTH) + (3 * (thread_count)))
+
+/* Size of the storage the caller must supply, aligned to TREIBER_CACHE_LINE */
+#define LIFO_MAG_STORAGE_SIZE(obj_count, obj_size, thread_count)                                  \
+    (((size_t)LIFO_MAG_COUNT(obj_count, thread_count) * sizeof(lifo_magazine_t)) +               \
+     (2u * LIFO_TREIBER_STORAGE_SIZE(LIFO_MAG_COUNT(obj_count, thread_count), sizeof(lifo_magazine_t *))) + \
+     LIFO_TREIBER_STORAGE_SIZE(obj_count, sizeof(lifo_mag_round_t)) +                           \
+     ((size_t)(obj_count) * LIFO_MAG_ALIGN((size_t)(obj_size))))
+
+/* Object pool structure declaration */
+typedef struct
+{
+    /* Depot of magazines holding objects */
+    lifo_treiber_t full;
+    /* Depot of magazines holding no object */
+    lifo_treiber_t empty;
+    /* Free objects that are in no magazine */
+    lifo_treiber_t spill;
+
+    /* Read only after initialization */
+    int obj_count;
+    int mag_count;
+    size_t obj_size;
+    lifo_magazine_t *magazines;
+    unsigned char *objects;
+} lifo_mag_pool_t;
+
+/* Cache of one thread, must not be shared between threads */
+typedef struct
+{
+    _Alignas(TREIBER_CACHE_LINE) lifo_mag_pool_t *pool;
+    lifo_magazine_t *loaded;
+    lifo_magazine_t *previous;
+} lifo_mag_cache_t;
+
+/* Function to swap the loaded and the previous magazine of a cache */
+static inline void lifo_mag_swap (lifo_mag_cache_t *cache)
+{
+    lifo_magazine_t *magazine = cache->loaded;
+    cache->loaded = cache->previous;
+    cache->previous = magazine;
+}
+
+/* Function to take an object from the pool, returns NULL when every object is in use */
+static inline void *lifo_mag_alloc (lifo_mag_cache_t *cache)
+{
+    lifo_mag_round_t object = NULL;
+
+    if (lifo_is_bufEmpty(&cache->loaded->rounds) != RC_LBUF_OK)
+    {
+        if (lifo_is_bufEmpty(&cache->previous->rounds) == RC_LBUF_OK)
+        {
+            lifo_mag_swap(cache);
+        }
+        else
+        {
+            /* Both magazines are empty, trade the previous one for a full magazine from the depot */
+            lifo_magazine_t *full;
+            if (lifo_treiber_pop(&cache->pool->full, &full) == RC_LBUF_OK)
+            {
+                (void) lifo_treiber_push(&cache->pool->empty, &cache->previous);
+                cache->previous = cache->loaded;
+                cache->loaded = full;
+            }
+            else
+            {
+                /* No full magazine, reload the empty one from the spill stack */
+                while ((lifo_is_bufFull(&cache->loaded->rounds) == RC_LBUF_OK) &&
+                       (lifo_treiber_pop(&cache->pool->spill, &object) == RC_LBUF_OK))
+                {
+                    (void) lifo_mag_round_push(&cache->loaded->rounds, &object);
+                }
+                object = NULL;
+            }
+        }
+    }
+    /* Leaves the object NULL if no magazine with objects was found */
+    (void) lifo_mag_round_pop(&cache->loaded->rounds, &object);
+    return object;
+}
+
+/* Function to give an object back to the pool */
+static inline lifo_rc_t lifo_mag_free (lifo_mag_cache_t *cache, void *object)
+{
+    lifo_mag_round_t round = object;
+
+    if (lifo_is_bufFull(&cache->loaded->rounds) != RC_LBUF_OK)
+    {
+        if (lifo_is_bufFull(&cache->previous->rounds) == RC_LBUF_OK)
+        {
+            lifo_mag_swap(cache);
+        }
+        else
+        {
+            /* Both magazines are full, trade the previous one for an empty magazine from the depot */
+            lifo_magazine_t *empty;
+            if (lifo_treiber_pop(&cache->pool->empty, &empty) == RC_LBUF_OK)
+            {
+                (void) lifo_treiber_push(&cache->pool->full, &cache->previous);
+                cache->previous = cache->loaded;
+                cache->loaded = empty;
+            }
+        }
+    }
+    lifo_rc_t rc = lifo_mag_round_push(&cache->loaded->rounds, &round);
+    if (rc != RC_LBUF_OK)
+    {
+        /* No empty magazine in the depot, the spill stack has room for every object */
+        rc = lifo_treiber_push(&cache->pool->spill, &round);
+    }
+    /* Only fails if more objects are freed than the pool holds */
+    return rc;
+}
+
+/* Initialize the cache of the calling thread with two empty magazines from the depot */
+static inline lifo_rc_t lifo_mag_cache_init (lifo_mag_cache_t *cache, lifo_mag_pool_t *pool)
+{
+    lifo_rc_t rc = RC_LBUF_ERR_EMPTY;
+
+    cache->pool = pool;
+    cache->loaded = NULL;
+    cache->previous = NULL;
+    if (lifo_treiber_pop(&pool->empty, &cache->loaded) == RC_LBUF_OK)
+    {
+        rc = lifo_treiber_pop(&pool->empty, &cache->previous);
+        if (rc != RC_LBUF_OK)
+        {
+            /* Not enough magazines for another thread, give the first one back */
+            (void) lifo_treiber_push(&pool->empty, &cache->loaded);
+            cache->loaded = NULL;
+        }
+    }
+    return rc;
+}
+
+/* Function to hand the magazines of a cache back to the depot, when the thread stops using the pool */
+static inline void lifo_mag_cache_flush (lifo_mag_cache_t *cache)
+{
+    lifo_mag_round_t round;
+
+    /* Pour the loaded magazine into the previous one, so at most one partly full magazine is left */
+    while ((lifo_is_bufFull(&cache->previous->rounds) == RC_LBUF_OK) &&
+           (lifo_mag_round_pop(&cache->loaded->rounds, &round) == RC_LBUF_OK))
+    {
+        (void) lifo_mag_round_push(&cache->previous->rounds, &round);
+    }
+    lifo_magazine_t *magazine[2] = { cache->loaded, cache->previous };
+    for (int i = 0; i < 2; i++)
+    {
+        if (lifo_is_bufFull(&magazine[i]->rounds) != RC_LBUF_OK)
+        {
+            (void) lifo_treiber_push(&cache->pool->full, &magazine[i]);
+        }
+        else
+        {
+            /* A partly full magazine would pile up in the full depot, spill its objects and return it empty */
+            while (lifo_mag_round_pop(&magazine[i]->rounds, &round) == RC_LBUF_OK)
+            {
+                (void) lifo_treiber_push(&cache->pool->spill, &round);
+            }
+            (void) lifo_treiber_push(&cache->pool->empty, &magazine[i]);
+        }
+    }
+    cache->loaded = NULL;
+    cache->previous = NULL;
+}
+
+/* Initialize the object pool over caller supplied storage of LIFO_MAG_STORAGE_SIZE bytes
+    Every object starts free, in full magazines in the depot.
+*/
+static inline void lifo_mag_pool_init (lifo_mag_pool_t *pool, void *storage, int obj_count, size_t obj_size, int thread_count)
+{
+    pool->obj_count = obj_count;
+    pool->mag_count = LIFO_MAG_COUNT(obj_count, thread_count);
+    pool->obj_size = LIFO_MAG_ALIGN(obj_size);
+
+    /* The storage holds the magazines, the nodes of both depots and of the spill stack, then the objects */
+    size_t depot_size = LIFO_TREIBER_STORAGE_SIZE(pool->mag_count, sizeof(lifo_magazine_t *));
+    pool->magazines = (lifo_magazine_t *)storage;
+    unsigned char *depot_storage = (unsigned char *)storage + ((size_t)pool->mag_count * sizeof(lifo_magazine_t));
+    lifo_treiber_init(&pool->full, depot_storage, (unsigned int)pool->mag_count, sizeof(lifo_magazine_t *));
+    lifo_treiber_init(&pool->empty, depot_storage + depot_size, (unsigned int)pool->mag_count, sizeof(lifo_magazine_t *));
+    lifo_treiber_init(&pool->spill, depot_storage + (2u * depot_size), (unsigned int)obj_count, sizeof(lifo_mag_round_t));
+    pool->objects = depot_storage + (2u * depot_size) + LIFO_TREIBER_STORAGE_SIZE(obj_count, sizeof(lifo_mag_round_t));
+
+    /* Load the objects into the magazines */
+    int next = 0;
+    for (int i = 0; i < pool->mag_count; i++)
+    {
+        lifo_magazine_t *magazine = &pool->magazines[i];
+        lifo_mag_round_init(&magazine->rounds, magazine->round, LIFO_MAGAZINE_LENGTH);
+        while ((next < obj_count) && (lifo_is_bufFull(&magazine->rounds) == RC_LBUF_OK))
+        {
+            lifo_mag_round_t round = pool->objects + ((size_t)next * pool->obj_size);
+            (void) lifo_mag_round_push(&magazine->rounds, &round);
+            next++;
+        }
+        (void) lifo_treiber_push((lifo_is_bufEmpty(&magazine->rounds) == RC_LBUF_OK) ? &pool->full : &pool->empty, &magazine);
+    }
+}
+
+/* De-Initialize the object pool, once every cache is flushed */
+static inline void lifo_mag_pool_deInit (lifo_mag_pool_t *pool)
+{
+    lifo_treiber_deInit(&pool->full);
+    lifo_treiber_deInit(&pool->empty);
+    lifo_treiber_deInit(&pool->spill);
+    pool->obj_count = 0;
+    pool->mag_count = 0;
+    pool->magazines = NULL;
+    pool->objects = NULL;
+}
+
+#endif /* LIFO_MAGAZINE_H */
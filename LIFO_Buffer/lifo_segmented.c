@@ -0,0 +1,130 @@
+/* Demonstration of the segmented LIFO buffer in lifo_segmented.h
+    Two stacks share one chunk pool. The first grows well past a single chunk while the second
+    stays shallow, then the first moves up and down across a chunk boundary, which its spare chunk
+    absorbs without touching the pool. Everything popped must come back in reverse order.
+*/
+
+/* Standard libarary includes */
+#include <stdio.h>
+
+/* The counters of -DBUF_STATS and the trace of -DBUF_TRACE are defined in this file */
+#define BUF_STATS_IMPLEMENTATION
+#define BUF_TRACE_IMPLEMENTATION
+
+#include "lifo_segmented.h"
+
+/* Elements per chunk and chunks in the shared pool */
+#define CHUNK_LENGTH            16
+#define CHUNK_COUNT             32
+
+/* Depth the deep stack grows to, and the depth the shallow stack grows to */
+#define DEEP_LENGTH             200
+#define SHALLOW_LENGTH          10
+
+/* Push/pop pairs made across a chunk boundary */
+#define BOUNDARY_COUNT          100000
+
+/* The data organized in structure */
+typedef struct
+{
+    int data_1;
+    int data_2;
+} data_t;
+
+/* Static allocation of data is preferred */
+_Alignas(max_align_t) unsigned char data[LIFO_CHUNK_POOL_SIZE(CHUNK_COUNT, CHUNK_LENGTH, sizeof(data_t))];
+
+lifo_chunk_pool_t lifo_chunk_pool_ctrl;
+lifo_seg_t lifo_deep_ctrl;
+lifo_seg_t lifo_shallow_ctrl;
+
+void print_element (int element_number, void *element)
+{
+    data_t *value = (data_t *)element;
+    printf("Element %d: data_1 = %d, data_2 = %d\n", element_number, value->data_1, value->data_2);
+}
+
+/* Function to print the depth of both stacks and the chunks left in the pool */
+void print_usage (const char *stage)
+{
+    printf("%-28s deep: %3d elements, shallow: %2d elements, free chunks: %2d of %d\n", stage,
+           lifo_deep_ctrl.count, lifo_shallow_ctrl.count, lifo_chunk_pool_ctrl.free_count, CHUNK_COUNT);
+}
+
+int main()
+{
+    printf("\nSegmented LIFO Buffer Implementation. %d chunks of %d elements\n", CHUNK_COUNT, CHUNK_LENGTH);
+    data_t element;
+    int errors = 0;
+
+    /* Initialize the shared pool and both stacks on it */
+    lifo_chunk_pool_init(&lifo_chunk_pool_ctrl, data, CHUNK_COUNT, CHUNK_LENGTH, sizeof(data_t));
+    lifo_seg_init(&lifo_deep_ctrl, &lifo_chunk_pool_ctrl);
+    lifo_seg_init(&lifo_shallow_ctrl, &lifo_chunk_pool_ctrl);
+    print_usage("Initialized");
+
+    for (int i = 0; i < DEEP_LENGTH; i++)
+    {
+        element.data_1 = i;
+        element.data_2 = -i;
+        (void) lifo_seg_push(&lifo_deep_ctrl, &element);
+    }
+    for (int i = 0; i < SHALLOW_LENGTH; i++)
+    {
+        element.data_1 = i;
+        element.data_2 = i;
+        (void) lifo_seg_push(&lifo_shallow_ctrl, &element);
+    }
+    print_usage("After growing");
+
+    /* Bring the deep stack to a chunk boundary and move across it */
+    while ((lifo_deep_ctrl.count % CHUNK_LENGTH) != 0)
+    {
+        (void) lifo_seg_pop(&lifo_deep_ctrl, &element);
+    }
+    int free_before = lifo_chunk_pool_ctrl.free_count;
+    for (int i = 0; i < BOUNDARY_COUNT; i++)
+    {
+        element.data_1 = i;
+        element.data_2 = -i;
+        (void) lifo_seg_push(&lifo_deep_ctrl, &element);
+        (void) lifo_seg_pop(&lifo_deep_ctrl, &element);
+    }
+    printf("%d push/pop pairs across a chunk boundary, pool %s\n", BOUNDARY_COUNT,
+           (lifo_chunk_pool_ctrl.free_count == free_before) ? "untouched" : "CHANGED");
+
+    /* Fill the pool up to see where the stacks stop growing */
+    int pushed = 0;
+    element.data_1 = 0;
+    element.data_2 = 0;
+    while (lifo_seg_push(&lifo_shallow_ctrl, &element) == RC_LBUF_OK)
+    {
+        pushed++;
+    }
+    printf("Shallow stack took %d more elements before the pool ran out\n", pushed);
+    print_usage("Pool exhausted");
+    for (int i = 0; i < pushed; i++)
+    {
+        (void) lifo_seg_pop(&lifo_shallow_ctrl, &element);
+    }
+
+    /* The remaining elements must come back newest first */
+    printf("\nShallow stack:\n");
+    (void) lifo_seg_traverse(&lifo_shallow_ctrl, print_element);
+    for (int i = lifo_deep_ctrl.count - 1; lifo_seg_pop(&lifo_deep_ctrl, &element) == RC_LBUF_OK; i--)
+    {
+        if ((element.data_1 != i) || (element.data_2 != -i))
+        {
+            errors++;
+        }
+    }
+    printf("\nDeep stack emptied, %d out of order\n", errors);
+
+    /* De-initialize both stacks, all chunks go back to the pool */
+    lifo_seg_deInit(&lifo_deep_ctrl);
+    lifo_seg_deInit(&lifo_shallow_ctrl);
+    print_usage("De-initialized");
+
+    printf("\nExited program");
+    return 0;
+}
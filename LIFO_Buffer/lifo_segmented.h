@@ -0,0 +1,249 @@
+/* A growable LIFO buffer made of fixed size chunks taken from a shared chunk pool
+
+    Instead of one array sized for the deepest the stack can ever get, the stack is a chain of chunks.
+    A new chunk is linked on top when the top chunk is full and unlinked when its last element is
+    popped. Existing elements are never copied, so a push is O(1) in the worst case.
+
+     ______________
+    |_DATA_|_DATA_|_______|_______| <- TOP CHUNK (top count = 2)
+           |
+     ______v______________________
+    |_DATA_|_DATA_|_DATA_|_DATA_|   <- full chunk below
+           |
+          NULL
+
+    Chunks come from a lifo_chunk_pool_t over caller supplied storage that any number of stacks can
+    share, so the memory used by each stack follows its actual depth. Every stack keeps the last chunk
+    it emptied as a spare and takes it back first, so a stack moving up and down around a chunk boundary
+    does not keep returning and fetching chunks from the pool.
+*/
+#ifndef LIFO_SEGMENTED_H
+#define LIFO_SEGMENTED_H
+
+/* Standard libarary includes */
+#include <stddef.h>
+#include <string.h>
+
+/* The return codes are shared with the basic LIFO buffer */
+#include "lifo_buf.h"
+
+/* Header of each chunk, the elements follow it */
+typedef struct lifo_chunk_t
+{
+    struct lifo_chunk_t *below;
+} lifo_chunk_t;
+
+/* Size of one chunk of chunk_length elements of elem_size bytes */
+#define LIFO_CHUNK_SIZE(chunk_length, elem_size) \
+    ((sizeof(lifo_chunk_t) + ((size_t)(chunk_length) * (elem_size)) + (_Alignof(max_align_t) - 1u)) & ~(_Alignof(max_align_t) - 1u))
+
+/* Size of the storage the caller must supply for a pool of chunk_count chunks */
+#define LIFO_CHUNK_POOL_SIZE(chunk_count, chunk_length, elem_size) \
+    ((size_t)(chunk_count) * LIFO_CHUNK_SIZE(chunk_length, elem_size))
+
+/* Pool of free chunks shared by the stacks */
+typedef struct
+{
+    int chunk_length;
+    int free_count;
+    size_t elem_size;
+    size_t chunk_size;
+    lifo_chunk_t *free;
+} lifo_chunk_pool_t;
+
+/* Segmented LIFO buffer structure declaration */
+typedef struct
+{
+    lifo_chunk_pool_t *pool;
+    lifo_chunk_t *top;
+    lifo_chunk_t *spare;
+    int top_count;
+    int count;
+} lifo_seg_t;
+
+/* Function to get the address of an element in a chunk */
+static inline void *lifo_chunk_slot (lifo_chunk_pool_t *pool, lifo_chunk_t *chunk, int index)
+{
+    return (void *)((unsigned char *)chunk + sizeof(lifo_chunk_t) + ((size_t)index * pool->elem_size));
+}
+
+/* Initialize a chunk pool over caller supplied storage of LIFO_CHUNK_POOL_SIZE bytes */
+static inline void lifo_chunk_pool_init (lifo_chunk_pool_t *pool, void *storage, int chunk_count, int chunk_length, size_t elem_size)
+{
+    pool->chunk_length = chunk_length;
+    pool->elem_size = elem_size;
+    pool->chunk_size = LIFO_CHUNK_SIZE(chunk_length, elem_size);
+    pool->free = NULL;
+    pool->free_count = chunk_count;
+
+    /* Chain all the chunks on the free list, the first chunk ends up on top */
+    for (int i = chunk_count - 1; i >= 0; i--)
+    {
+        lifo_chunk_t *chunk = (lifo_chunk_t *)((unsigned char *)storage + ((size_t)i * pool->chunk_size));
+        chunk->below = pool->free;
+        pool->free = chunk;
+    }
+}
+
+/* Function to return a chunk to the pool */
+static inline void lifo_chunk_pool_put (lifo_chunk_pool_t *pool, lifo_chunk_t *chunk)
+{
+    chunk->below = pool->free;
+    pool->free = chunk;
+    pool->free_count++;
+}
+
+/* Function to take a chunk for a stack, its own spare first, returns NULL when the pool is exhausted */
+static inline lifo_chunk_t *lifo_seg_get_chunk (lifo_seg_t *lifo)
+{
+    lifo_chunk_t *chunk = lifo->spare;
+
+    if (chunk != NULL)
+    {
+        lifo->spare = NULL;
+    }
+    else if (lifo->pool->free != NULL)
+    {
+        chunk = lifo->pool->free;
+        lifo->pool->free = chunk->below;
+        lifo->pool->free_count--;
+    }
+    return chunk;
+}
+
+/* Function to give an emptied chunk up, kept as the spare if the stack has none */
+static inline void lifo_seg_put_chunk (lifo_seg_t *lifo, lifo_chunk_t *chunk)
+{
+    if (lifo->spare == NULL)
+    {
+        lifo->spare = chunk;
+    }
+    else
+    {
+        lifo_chunk_pool_put(lifo->pool, chunk);
+    }
+}
+
+/* Function to check if the segmented LIFO buffer is empty */
+static inline lifo_rc_t lifo_seg_is_bufEmpty (lifo_seg_t *lifo)
+{
+    lifo_rc_t rc = RC_LBUF_OK;
+
+    if (lifo->count == 0)
+    {
+        rc = RC_LBUF_ERR_EMPTY;
+    }
+    return rc;
+}
+
+/* Funtion to push an element into the segmented LIFO buffer, full only when the pool has no chunk left */
+static inline lifo_rc_t lifo_seg_push (lifo_seg_t *lifo, const void *element)
+{
+    lifo_rc_t rc = RC_LBUF_OK;
+
+    /* Link a new chunk on top when there is no room in the top chunk */
+    if ((lifo->top == NULL) || (lifo->top_count == lifo->pool->chunk_length))
+    {
+        lifo_chunk_t *chunk = lifo_seg_get_chunk(lifo);
+        if (chunk == NULL)
+        {
+            rc = RC_LBUF_ERR_FULL;
+        }
+        else
+        {
+            chunk->below = lifo->top;
+            lifo->top = chunk;
+            lifo->top_count = 0;
+        }
+    }
+
+    if (rc == RC_LBUF_OK)
+    {
+        /* Copy the element above the others in the top chunk */
+        (void) memcpy (lifo_chunk_slot(lifo->pool, lifo->top, lifo->top_count), element, lifo->pool->elem_size);
+        lifo->top_count++;
+        lifo->count++;
+    }
+    return rc;
+}
+
+/* Function to pop an element from the segmented LIFO buffer */
+static inline lifo_rc_t lifo_seg_pop (lifo_seg_t *lifo, void *element)
+{
+    /* Check if the buffer is empty */
+    lifo_rc_t rc = lifo_seg_is_bufEmpty(lifo);
+
+    if (rc == RC_LBUF_OK)
+    {
+        /* Copy the top element out */
+        lifo->top_count--;
+        lifo->count--;
+        (void) memcpy (element, lifo_chunk_slot(lifo->pool, lifo->top, lifo->top_count), lifo->pool->elem_size);
+
+        /* Unlink the top chunk once it is empty, the chunk below is always full */
+        if (lifo->top_count == 0)
+        {
+            lifo_chunk_t *chunk = lifo->top;
+            lifo->top = chunk->below;
+            lifo->top_count = (lifo->top != NULL) ? lifo->pool->chunk_length : 0;
+            lifo_seg_put_chunk(lifo, chunk);
+        }
+    }
+    return rc;
+}
+
+/* Function to traverse through the segmented LIFO buffer, newest first */
+static inline lifo_rc_t lifo_seg_traverse (lifo_seg_t *lifo, lifo_visit_t visit)
+{
+    /* Check if the buffer is empty */
+    lifo_rc_t rc = lifo_seg_is_bufEmpty(lifo);
+
+    if (rc == RC_LBUF_OK)
+    {
+        int element_number = lifo->count;
+        int index = lifo->top_count;
+
+        /* Walk down each chunk, then on to the chunk below */
+        for (lifo_chunk_t *chunk = lifo->top; chunk != NULL; chunk = chunk->below)
+        {
+            while (index > 0)
+            {
+                index--;
+                visit(element_number--, lifo_chunk_slot(lifo->pool, chunk, index));
+            }
+            index = lifo->pool->chunk_length;
+        }
+    }
+    return rc;
+}
+
+/* Initialize the segmented LIFO buffer on a chunk pool, it takes no chunk until the first push */
+static inline void lifo_seg_init (lifo_seg_t *lifo, lifo_chunk_pool_t *pool)
+{
+    lifo->pool = pool;
+    lifo->top = NULL;
+    lifo->spare = NULL;
+    lifo->top_count = 0;
+    lifo->count = 0;
+}
+
+/* De-Initialize the segmented LIFO buffer, returning all its chunks to the pool */
+static inline void lifo_seg_deInit (lifo_seg_t *lifo)
+{
+    while (lifo->top != NULL)
+    {
+        lifo_chunk_t *chunk = lifo->top;
+        lifo->top = chunk->below;
+        lifo_chunk_pool_put(lifo->pool, chunk);
+    }
+    /* Hand the spare back as well */
+    if (lifo->spare != NULL)
+    {
+        lifo_chunk_pool_put(lifo->pool, lifo->spare);
+        lifo->spare = NULL;
+    }
+    lifo->top_count = 0;
+    lifo->count = 0;
+}
+
+#endif /* LIFO_SEGMENTED_H */
@@ -0,0 +1,121 @@
+/* Demonstration of the lock-free LIFO buffer in lifo_treiber.h
+    Every thread repeatedly pushes a burst of elements and pops the same number back, on one shared
+    buffer, for 1, 2, 4 and 8 threads. The sum of everything popped must match what was pushed.
+*/
+
+/* Standard libarary includes */
+#include <stdio.h>
+#include <pthread.h>
+#include <time.h>
+
+/* The counters of -DBUF_STATS and the trace of -DBUF_TRACE are defined in this file */
+#define BUF_STATS_IMPLEMENTATION
+#define BUF_TRACE_IMPLEMENTATION
+
+#include "lifo_treiber.h"
+
+/* Buffer size */
+#define BUFFER_LENGTH           1024
+
+/* Push/pop pairs made on each run, shared between the threads */
+#define OPERATION_COUNT         8000000
+
+/* Elements pushed by a thread before it pops them back */
+#define BURST_LENGTH            8
+
+/* Largest number of threads */
+#define MAX_THREADS             8
+
+/* The data organized in structure */
+typedef struct
+{
+    int data_1;
+    int data_2;
+} data_t;
+
+/* Static allocation of data is preferred */
+_Alignas(TREIBER_CACHE_LINE) unsigned char data[LIFO_TREIBER_STORAGE_SIZE(BUFFER_LENGTH, sizeof(data_t))];
+
+lifo_treiber_t lifo_treiber_ctrl;
+
+/* Work assigned to one thread */
+typedef struct
+{
+    int count;
+    long long pushed;
+    long long popped;
+} worker_t;
+
+void *worker (void *arg)
+{
+    worker_t *work = (worker_t *)arg;
+    data_t element;
+
+    for (int i = 0; i < work->count; i += BURST_LENGTH)
+    {
+        for (int j = 0; j < BURST_LENGTH; j++)
+        {
+            element.data_1 = i + j;
+            element.data_2 = 0;
+            if (lifo_treiber_push(&lifo_treiber_ctrl, &element) == RC_LBUF_OK)
+            {
+                work->pushed += element.data_1;
+            }
+        }
+        for (int j = 0; j < BURST_LENGTH; j++)
+        {
+            /* Another thread may have popped this thread's elements, any element will do */
+            if (lifo_treiber_pop(&lifo_treiber_ctrl, &element) == RC_LBUF_OK)
+            {
+                work->popped += element.data_1;
+            }
+        }
+    }
+    return arg;
+}
+
+int main()
+{
+    printf("\nLock-free LIFO Buffer Implementation. Length of buffer: %d\n", BUFFER_LENGTH);
+    pthread_t threads[MAX_THREADS];
+    worker_t workers[MAX_THREADS];
+    struct timespec start, stop;
+    data_t element;
+
+    for (int thread_count = 1; thread_count <= MAX_THREADS; thread_count *= 2)
+    {
+        long long pushed = 0, popped = 0;
+
+        /* Initialize the lock-free LIFO buffer over the static pool */
+        lifo_treiber_init(&lifo_treiber_ctrl, data, BUFFER_LENGTH, sizeof(data_t));
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i = 0; i < thread_count; i++)
+        {
+            workers[i] = (worker_t){ .count = OPERATION_COUNT / thread_count, .pushed = 0, .popped = 0 };
+            pthread_create(&threads[i], NULL, worker, &workers[i]);
+        }
+        for (int i = 0; i < thread_count; i++)
+        {
+            pthread_join(threads[i], NULL);
+            pushed += workers[i].pushed;
+            popped += workers[i].popped;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+
+        /* Collect whatever is left on the stack */
+        while (lifo_treiber_pop(&lifo_treiber_ctrl, &element) == RC_LBUF_OK)
+        {
+            popped += element.data_1;
+        }
+
+        double seconds = (stop.tv_sec - start.tv_sec) + ((stop.tv_nsec - start.tv_nsec) / 1e9);
+        printf("%d threads: %.1f million push/pop pairs/s, %s\n", thread_count, (OPERATION_COUNT / seconds) / 1e6,
+               (pushed == popped) ? "all elements received" : "MISMATCH");
+
+        lifo_treiber_deInit(&lifo_treiber_ctrl);
+    }
+
+    printf("\nExited program");
+    return 0;
+}
@@ -0,0 +1,222 @@
+/* A lock-free LIFO buffer (Treiber stack) that any number of threads may push to and pop from
+
+    The elements live in a fixed pool of nodes supplied by the caller. Each node holds the index of
+    the node below it and the element. Two stacks are kept over the pool with the same algorithm:
+    the stack of elements, and the free stack of unused nodes.
+
+     ______                     ______
+    |_NODE_| <- TOP            |_NODE_| <- FREE
+    |_NODE_|                   |_NODE_|
+    |_NODE_|                   |______|
+     Elements                   Free nodes
+
+    Push: take a node from the free stack, copy the element into it, then CAS it onto the top.
+    Pop:  CAS the top to the node below it, copy the element out, then put the node on the free stack.
+
+    Each top is a 64-bit word holding a 32-bit node index and a 32-bit version tag that changes on every
+    successful CAS. A thread that read the top, was delayed while the same node was popped and pushed
+    again, and then tries its CAS sees a different tag and retries (no ABA problem). As nodes never
+    leave the pool, a stale read of a node is always of valid memory, so no hazard pointers are needed.
+*/
+#ifndef LIFO_TREIBER_H
+#define LIFO_TREIBER_H
+
+/* Standard libarary includes */
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+
+/* The return codes are shared with the basic LIFO buffer */
+#include "lifo_buf.h"
+
+/* Size of a cache line, used to keep the two tops apart */
+#define TREIBER_CACHE_LINE      64
+
+/* Index of no node, ends a stack */
+#define TREIBER_NIL             UINT32_MAX
+
+/* Header of each node, the element follows it */
+typedef struct
+{
+    atomic_uint next;
+} lifo_treiber_node_t;
+
+/* Size of one node holding an element of elem_size bytes */
+#define LIFO_TREIBER_NODE_SIZE(elem_size) \
+    ((sizeof(lifo_treiber_node_t) + (elem_size) + (_Alignof(max_align_t) - 1u)) & ~(_Alignof(max_align_t) - 1u))
+
+/* Size of the node pool the caller must supply for length elements */
+#define LIFO_TREIBER_STORAGE_SIZE(length, elem_size)    ((size_t)(length) * LIFO_TREIBER_NODE_SIZE(elem_size))
+
+/* Lock-free LIFO buffer structure declaration */
+typedef struct
+{
+    /* Tagged top of the element stack */
+    _Alignas(TREIBER_CACHE_LINE) atomic_ullong top;
+    /* Tagged top of the free node stack */
+    _Alignas(TREIBER_CACHE_LINE) atomic_ullong free;
+
+    /* Read only after initialization */
+    _Alignas(TREIBER_CACHE_LINE) unsigned int length;
+    size_t elem_size;
+    size_t node_size;
+    unsigned char *pool;
+} lifo_treiber_t;
+
+/* Function to get the node at an index */
+static inline lifo_treiber_node_t *lifo_treiber_node (lifo_treiber_t *lifo, uint32_t index)
+{
+    return (lifo_treiber_node_t *)(lifo->pool + ((size_t)index * lifo->node_size));
+}
+
+/* Function to get the element stored in a node */
+static inline void *lifo_treiber_element (lifo_treiber_node_t *node)
+{
+    return (void *)((unsigned char *)node + sizeof(lifo_treiber_node_t));
+}
+
+/* Function to build a tagged top from a node index and a version tag */
+static inline unsigned long long lifo_treiber_tag (uint32_t index, uint32_t version)
+{
+    return ((unsigned long long)version << 32) | index;
+}
+
+/* Function to push a node onto one of the two stacks */
+static inline void lifo_treiber_push_node (lifo_treiber_t *lifo, atomic_ullong *top, uint32_t index)
+{
+    lifo_treiber_node_t *node = lifo_treiber_node(lifo, index);
+    unsigned long long old_top = atomic_load_explicit(top, memory_order_relaxed);
+    unsigned long long new_top;
+
+    for (;;)
+    {
+        /* Link the node above the current top, and move to the next version */
+        atomic_store_explicit(&node->next, (uint32_t)old_top, memory_order_relaxed);
+        new_top = lifo_treiber_tag(index, (uint32_t)(old_top >> 32) + 1u);
+        /* Release publishes the element and the link to whoever pops the node */
+        if (atomic_compare_exchange_weak_explicit(top, &old_top, new_top, memory_order_release, memory_order_relaxed))
+        {
+            break;
+        }
+        BUF_STAT_ADD(BUF_STATS_LIFO, BUF_STAT_RETRY, 1u);
+    }
+}
+
+/* Function to pop a node from one of the two stacks, returns TREIBER_NIL when the stack is empty */
+static inline uint32_t lifo_treiber_pop_node (lifo_treiber_t *lifo, atomic_ullong *top)
+{
+    unsigned long long old_top = atomic_load_explicit(top, memory_order_acquire);
+    unsigned long long new_top;
+    uint32_t index;
+
+    for (;;)
+    {
+        index = (uint32_t)old_top;
+        if (index == TREIBER_NIL)
+        {
+            break;
+        }
+        /* The node may be popped by another thread meanwhile, then the tag makes the CAS fail */
+        uint32_t next = atomic_load_explicit(&lifo_treiber_node(lifo, index)->next, memory_order_relaxed);
+        new_top = lifo_treiber_tag(next, (uint32_t)(old_top >> 32) + 1u);
+        if (atomic_compare_exchange_weak_explicit(top, &old_top, new_top, memory_order_acquire, memory_order_acquire))
+        {
+            break;
+        }
+        BUF_STAT_ADD(BUF_STATS_LIFO, BUF_STAT_RETRY, 1u);
+    }
+    return index;
+}
+
+/* Funtion to push an element into the lock-free LIFO buffer */
+static inline lifo_rc_t lifo_treiber_push (lifo_treiber_t *lifo, const void *element)
+{
+    BUF_STAT_START(start);
+    lifo_rc_t rc = RC_LBUF_ERR_FULL;
+    /* Take an unused node, the buffer is full when there is none */
+    uint32_t index = lifo_treiber_pop_node(lifo, &lifo->free);
+
+    BUF_STAT_ADD(BUF_STATS_LIFO, BUF_STAT_OPS, 1u);
+    if (index != TREIBER_NIL)
+    {
+        /* The node is owned by this thread until it is pushed */
+        (void) memcpy (lifo_treiber_element(lifo_treiber_node(lifo, index)), element, lifo->elem_size);
+        lifo_treiber_push_node(lifo, &lifo->top, index);
+        rc = RC_LBUF_OK;
+    }
+    else
+    {
+        BUF_STAT_ADD(BUF_STATS_LIFO, BUF_STAT_FULL, 1u);
+    }
+    BUF_STAT_STOP(BUF_STATS_LIFO, start);
+    BUF_TRACE_OP(BUF_STATS_LIFO, BUF_TRACE_ADD, 0, (rc != RC_LBUF_OK));
+    return rc;
+}
+
+/* Function to pop an element from the lock-free LIFO buffer */
+static inline lifo_rc_t lifo_treiber_pop (lifo_treiber_t *lifo, void *element)
+{
+    BUF_STAT_START(start);
+    lifo_rc_t rc = RC_LBUF_ERR_EMPTY;
+    uint32_t index = lifo_treiber_pop_node(lifo, &lifo->top);
+
+    BUF_STAT_ADD(BUF_STATS_LIFO, BUF_STAT_OPS, 1u);
+    if (index != TREIBER_NIL)
+    {
+        /* The node is owned by this thread until it is returned to the free stack */
+        (void) memcpy (element, lifo_treiber_element(lifo_treiber_node(lifo, index)), lifo->elem_size);
+        lifo_treiber_push_node(lifo, &lifo->free, index);
+        rc = RC_LBUF_OK;
+    }
+    else
+    {
+        BUF_STAT_ADD(BUF_STATS_LIFO, BUF_STAT_EMPTY, 1u);
+    }
+    BUF_STAT_STOP(BUF_STATS_LIFO, start);
+    BUF_TRACE_OP(BUF_STATS_LIFO, BUF_TRACE_REMOVE, 0, (rc != RC_LBUF_OK));
+    return rc;
+}
+
+/* Function to check if the lock-free LIFO buffer is empty, only a snapshot while other threads run */
+static inline lifo_rc_t lifo_treiber_is_bufEmpty (lifo_treiber_t *lifo)
+{
+    lifo_rc_t rc = RC_LBUF_OK;
+
+    if ((uint32_t)atomic_load_explicit(&lifo->top, memory_order_acquire) == TREIBER_NIL)
+    {
+        rc = RC_LBUF_ERR_EMPTY;
+    }
+    return rc;
+}
+
+/* Initialize the lock-free LIFO buffer over a caller supplied pool of LIFO_TREIBER_STORAGE_SIZE bytes */
+static inline void lifo_treiber_init (lifo_treiber_t *lifo, void *storage, unsigned int length, size_t elem_size)
+{
+    /* Set the buffer size */
+    lifo->length = length;
+    lifo->elem_size = elem_size;
+    lifo->node_size = LIFO_TREIBER_NODE_SIZE(elem_size);
+    lifo->pool = (unsigned char *)storage;
+
+    /* Chain every node onto the free stack, the element stack starts empty */
+    for (unsigned int i = 0; i < length; i++)
+    {
+        atomic_init(&lifo_treiber_node(lifo, i)->next, ((i + 1u) < length) ? (i + 1u) : TREIBER_NIL);
+    }
+    atomic_init(&lifo->free, lifo_treiber_tag((length > 0u) ? 0u : TREIBER_NIL, 0u));
+    atomic_init(&lifo->top, lifo_treiber_tag(TREIBER_NIL, 0u));
+}
+
+/* De-Initialize the lock-free LIFO buffer */
+static inline void lifo_treiber_deInit (lifo_treiber_t *lifo)
+{
+    /* Set the buffer size */
+    lifo->length = 0u;
+    /* Make the pool point to NULL */
+    lifo->pool = NULL;
+    atomic_store(&lifo->free, lifo_treiber_tag(TREIBER_NIL, 0u));
+    atomic_store(&lifo->top, lifo_treiber_tag(TREIBER_NIL, 0u));
+}
+
+#endif /* LIFO_TREIBER_H */
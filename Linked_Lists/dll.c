@@ -1,295 +1,68 @@
-/* A basic implementation of a statically allocated Doubly Linked List (DLL) buffer 
+/* Demonstration of the statically allocated Doubly Linked List (DLL) buffer in dll.h
     An element can be added only at the tail, but can be removed from anywhere.
+    Elements are found by index through the index of the list, without walking it.
+    Every element with data below a value can be removed in one pass.
 */
-#include <stdio.h>
-#include <string.h>
-#include <stdbool.h>
+
+/* The counters of -DBUF_STATS and the trace of -DBUF_TRACE are defined in this file */
+#define BUF_STATS_IMPLEMENTATION
+#define BUF_TRACE_IMPLEMENTATION
+
+#include "dll.h"
 
 /* Buffer size */
 #define BUFFER_LENGTH           10
 
 
 /* The data organized in structure */
-typedef struct data_t
+typedef struct
 {
     int idx;
     int data;
-    struct data_t *next;
-    struct data_t *prev;
 } data_t;
 
 /* Static allocation of data is preferred */
-data_t data[BUFFER_LENGTH];
-
-/* LIFO buffer structure declaration */
-typedef struct 
-{
-    int length;
-    int alloc_count;
-    data_t *base;
-    data_t *end;
-    data_t *head;
-    data_t *tail;
-} dll_buf_t;
+_Alignas(dll_node_t) unsigned char data[DLL_STORAGE_SIZE(BUFFER_LENGTH, sizeof(data_t))];
 
 dll_buf_t dll_buf_ctrl;
 
-/* DLL buffer return code */
-typedef enum 
-{
-    RC_DLLBUF_OK,
-    RC_DLLBUF_ERR_FULL,
-    RC_DLLBUF_ERR_EMPTY,
-    RC_DLLBUF_NOT_FOUND,
-} dll_rc_t;
+/* DLL functions specialized for data_t: data_dll_add, data_dll_remove, data_dll_find */
+DLL_BUF_DEFINE(data_dll, data_t)
 
 void debug_dll_pointer(void)
 {
     
 }
 
-/* Function to check if the DLL buffer is empty */
-dll_rc_t dll_is_bufEmpty (void)
-{
-    dll_rc_t rc = RC_DLLBUF_OK;
-
-    /* If the allocated count is 0, then the buffer is empty */
-    if (dll_buf_ctrl.alloc_count == 0)
-    {
-        rc = RC_DLLBUF_ERR_EMPTY;
-    }
-    return rc;
-}
-
-/* Function to check if the DLL buffer is full */
-dll_rc_t dll_is_bufFull (void)
-{
-    dll_rc_t rc = RC_DLLBUF_OK;
-
-    /* If the allocated count is 0, then the buffer is empty */
-    if (dll_buf_ctrl.alloc_count == dll_buf_ctrl.length)
-    {
-        rc = RC_DLLBUF_ERR_FULL;
-    }
-    return rc;
-}
-
-/* Funtion to add an element into the DLL buffer */
-dll_rc_t dll_add (data_t *element)
-{
-    /* Check if the buffer is full */
-    dll_rc_t rc = dll_is_bufFull();
-    /* Get the tail */
-    data_t *tail = dll_buf_ctrl.tail;
-
-    if (rc == RC_DLLBUF_OK)
-    {
-        /* Element will be added to tail always */
-        if (dll_buf_ctrl.alloc_count == 0)
-        {
-            /* Queue is empty */
-            memset ((void *)tail, 0u, sizeof(element));
-            memcpy ((void *)tail, (void *)element, sizeof(element));
-        }
-        else
-        {
-            /* There are elements present in queue */
-            /* Add the new element at the end of tail */
-            tail = tail->next;
-            /* Link the prev of newly added element to the old tail */
-            tail->prev = dll_buf_ctrl.tail;
-            /* Copy the element */
-            memset ((void *)tail, 0u, sizeof(element));
-            memcpy ((void *)tail, (void *)element, sizeof(element));
-
-            /* Update the new tail */
-            dll_buf_ctrl.tail = tail;
-        }
-        dll_buf_ctrl.alloc_count++;
-    }
-    return rc;
-}
-
-/* Function to pop and element from the LIFO buffer */
-dll_rc_t dll_remove (data_t *element, bool conv_remove, int idx)
-{
-    /* Check if the buffer is empty */
-    dll_rc_t rc = dll_is_bufEmpty();
-
-    if (rc == RC_DLLBUF_OK) 
-    {
-        /* Store the head that is removed for later operations */
-        data_t *head = dll_buf_ctrl.head, *tail = dll_buf_ctrl.tail, *end = dll_buf_ctrl.end;
-
-        if (conv_remove)
-        {
-            data_t *remove_element = dll_buf_ctrl.head;
-            /* Remove the element from the head in case of conventional remove */
-            memcpy ((void *)element, (void *)remove_element, sizeof(element));
-            if (dll_buf_ctrl.alloc_count > 1)
-            {
-                /* Move the current head */
-                head = head->next;
-                /* De-link the previous pointer as the element is removed */
-                head->prev = NULL;
-                /* The removed element is the end of queue so de-link the next */
-                remove_element->next = NULL;
-                /* Assign next of old end to the current element */
-                end->next = remove_element;
-                /* Update the end to the last removed element */
-                dll_buf_ctrl.end = remove_element;
-                /* Update the new head */
-                dll_buf_ctrl.head = head;
-            }
-            dll_buf_ctrl.alloc_count--;
-        }
-        else
-        {
-            rc = RC_DLLBUF_NOT_FOUND;
-            /* Always start from the head */
-            data_t *traverse_var = head;
-
-            if (dll_buf_ctrl.alloc_count == 1)
-            {
-                /* Index matched */
-                if (traverse_var->idx == idx)
-                {
-                    /* Remove the only element present in the queue if index matches */
-                    memcpy ((void *)element, (void *)traverse_var, sizeof(element));
-                    /* Decrement the count */
-                    dll_buf_ctrl.alloc_count--;
-                    rc = RC_DLLBUF_OK;
-                }
-            }
-            else
-            {
-                do
-                {
-                    /* Index of the search element matched */
-                    if (traverse_var->idx == idx)
-                    {
-                        /* Remove the element from the middle in case of conditional remove */
-                        memcpy ((void *)element, (void *)traverse_var, sizeof(element));
-                        /* The element matched is the head */
-                        if (traverse_var == head)
-                        {
-                            /* Move the head to the next pointing element */
-                            head = head->next;
-                            /* De-link the previous of the head */
-                            head->prev = NULL;
-                            /* Update the new head */
-                            dll_buf_ctrl.head = head;
-                        }
-                        else if (traverse_var == tail)
-                        {
-                            /* The element matched is tail */
-                            /* Move the tail backward by one */
-                            tail = tail->prev;
-                            /* Assign the next of tail to the next elemenet in queue */
-                            tail->next = traverse_var->next;
-                            /* Update the new tail */
-                            dll_buf_ctrl.tail = tail;
-                        }
-                        else
-                        {
-                            traverse_var->prev->next = traverse_var->next;
-                            traverse_var->next->prev = traverse_var->prev;
-                        }
-                        /* De-link the prev and next removed element */
-                        traverse_var->prev = traverse_var->next = NULL;
-                        /* Link the previous end to the newly removed element */
-                        end->next = traverse_var;
-                        /* Assign the end as the newly removed element */
-                        dll_buf_ctrl.end = traverse_var;
-                        /* Decrement the count */
-                        dll_buf_ctrl.alloc_count--;
-
-                        rc = RC_DLLBUF_OK;
-                        /* Break the loop in case of element match */
-                        break;
-                    }
-                    else
-                    {
-                        /* Move to the next element if index not matched */
-                        traverse_var = traverse_var->next;
-                    }
-                    /* Move till the tail of the queue */
-                } while (traverse_var != tail->next);
-            }
-        }
-    }
-    return rc;
-}
-
-dll_rc_t dll_traverse (void)
+/* Function to print an element while traversing */
+void print_element (int idx, void *element)
 {
-    /* Check if the buffer is empty */
-    dll_rc_t rc = dll_is_bufEmpty();
-
-    if (rc == RC_DLLBUF_OK) 
-    {
-        /* Always start from the head */
-        data_t *traverse_var = dll_buf_ctrl.head, *tail = dll_buf_ctrl.tail;
-        do
-        {
-            /* Print the index and data of elements in the queue */
-            printf ("[Idx: %d, Data: %d] -> ", traverse_var->idx, traverse_var->data);
-            traverse_var = traverse_var->next;
-        } while (traverse_var != tail->next);
-        printf ("End\n");
-    }
-    return rc;
+    printf ("[Idx: %d, Data: %d] -> ", idx, ((data_t *)element)->data);
 }
 
-/* Initialize the LIFO buffer */
-void dll_init (void)
-{
-    /* Set the buffer size */
-    dll_buf_ctrl.length = BUFFER_LENGTH;
-    /* Initialize the allocated count */
-    dll_buf_ctrl.alloc_count = 0;
-    /* Make the base of the buffer point to the 0th element of the array */
-    dll_buf_ctrl.base = &data[0];
-    /* Make the head and tail point to the base as the buffer is empty */
-    dll_buf_ctrl.tail = dll_buf_ctrl.head = dll_buf_ctrl.base;
-    /* Do not use the prev and next of the head tail and base */
-    dll_buf_ctrl.tail->prev = dll_buf_ctrl.head->prev = dll_buf_ctrl.base->prev = NULL;
-    dll_buf_ctrl.tail->next = dll_buf_ctrl.head->next = dll_buf_ctrl.base->next = NULL;
-
-    for (int i = 0; i < (dll_buf_ctrl.length - 1); i++)
-    {
-        /* Link all the nodes in the queue with next */
-        data[i].next = &data[i + 1];
-    }
-    /* Initialize the end of the queue as last element in the DLL */
-    dll_buf_ctrl.end = &data[dll_buf_ctrl.length - 1];
-    /* Do not use the prev and next of the end */
-    dll_buf_ctrl.end->prev = dll_buf_ctrl.end->next = NULL;
-
-    /* There is no element after end' */
-    data[dll_buf_ctrl.length - 1].next = NULL;
-}
+/* Elements with data below this value are removed by the purge */
+int purge_below;
 
-/* De-Initialize the LIFO buffer */
-void dll_deInit (void)
+/* Function to select the elements removed by the purge */
+bool is_below (int idx, const void *element)
 {
-    /* Set the buffer size */
-    dll_buf_ctrl.length = 0;
-    /* Make the base of the buffer point to NULL */
-    dll_buf_ctrl.base = NULL;
-    /* Make the head and tail point to the NULL */
-    dll_buf_ctrl.tail = dll_buf_ctrl.head = dll_buf_ctrl.base;
+    (void) idx;
+    return ((const data_t *)element)->data < purge_below;
 }
 
 void debug_pointers (void)
 {
     for (int i = 0; i < 4; i++)
-        printf ("%d   %d   %d\n", data[i].prev - &data[0], &data[i] - &data[0], data[i].next - &data[0]);
+    {
+        dll_node_t *node = dll_node(&dll_buf_ctrl, i);
+        printf ("%d   %d   %d\n", (int)(((unsigned char *)node->prev - data) / dll_buf_ctrl.node_size), i,
+                (int)(((unsigned char *)node->next - data) / dll_buf_ctrl.node_size));
+    }
 }
 
 dll_rc_t dll_run_test (void)
 {
-    
+    return RC_DLLBUF_OK;
 }
 
 int main()
@@ -300,12 +73,12 @@ int main()
     dll_rc_t rc;
     
     /* Initialize the LIFO buffer */
-    dll_init();
+    data_dll_init(&dll_buf_ctrl, data, BUFFER_LENGTH);
 
-    /* 1 to push, 2 to pop, 3 to exit */
-    while (symbol != '4')
+    /* 1 to push, 2 to pop, 3 to traverse, 4 to find, 5 to purge, 6 to exit */
+    while (symbol != '6')
     {
-        printf("\nEnter 1 to add, 2 to remove, 3 to traverse, and 4 to exit: ");
+        printf("\nEnter 1 to add, 2 to remove, 3 to traverse, 4 to find, 5 to purge, and 6 to exit: ");
         scanf(" %c", &symbol);
 
         switch (symbol)
@@ -317,7 +90,7 @@ int main()
                 scanf("%d", &element.idx);
                 printf("Data: ");
                 scanf("%d", &element.data);
-                rc = dll_add(&element);
+                rc = data_dll_add(&dll_buf_ctrl, element.idx, &element);
 
                 if (rc == RC_DLLBUF_OK) 
                 {
@@ -338,14 +111,14 @@ int main()
 
                 if (conv_remove == 'Y')
                 {
-                    rc = dll_remove (&element, true, 0);
+                    rc = data_dll_remove (&dll_buf_ctrl, &element, true, 0);
                 }
                 else
                 {
                     int idx;
                     printf ("\nEnter the index to search: ");
                     scanf (" %d", &idx);
-                    rc = dll_remove (&element, false, idx);
+                    rc = data_dll_remove (&dll_buf_ctrl, &element, false, idx);
                 }
 
                 if (rc == RC_DLLBUF_OK) 
@@ -366,7 +139,11 @@ int main()
             case '3':
             {
                 /* Traverse the LIFO buffer */
-                rc = dll_traverse();
+                rc = dll_traverse(&dll_buf_ctrl, print_element);
+                if (rc == RC_DLLBUF_OK)
+                {
+                    printf ("End\n");
+                }
                 
                 if (rc != RC_DLLBUF_OK)
                 {
@@ -375,16 +152,52 @@ int main()
                 }
             }
             break;
+            case '4':
+            {
+                int idx;
+                /* Look the oldest element with the index up, it stays in the list */
+                printf ("\nEnter the index to search: ");
+                scanf (" %d", &idx);
+                rc = data_dll_find (&dll_buf_ctrl, idx, &element);
+
+                if (rc == RC_DLLBUF_OK)
+                {
+                    printf("\nIdx: %d, Data: %d\n", element.idx, element.data);
+                }
+                else
+                {
+                    printf ("\nElement not found. \n");
+                }
+            }
+            break;
+            case '5':
+            {
+                data_t removed[BUFFER_LENGTH];
+                /* Remove every element with data below the value in one pass */
+                printf ("\nEnter the value to remove data below: ");
+                scanf (" %d", &purge_below);
+                int count = dll_remove_if (&dll_buf_ctrl, is_below, removed);
+
+                printf("\n%d elements removed.\n", count);
+                for (int i = 0; i < count; i++)
+                {
+                    printf("Idx: %d, Data: %d\n", removed[i].idx, removed[i].data);
+                }
+            }
+            break;
             default:
             {
-                /* Exit on 4 */
+                /* Exit on 6 */
                 break;
             }
         }
     }
 
+    /* Counters of the hot paths, when built with -DBUF_STATS */
+    buf_stats_print(BUF_STATS_DLL);
+
     /* De-init the pointers */
-    dll_deInit();
+    dll_deInit(&dll_buf_ctrl);
     printf("\nExited program");
     return 0;
 }
\ No newline at end of file
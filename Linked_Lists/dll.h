@@ -0,0 +1,1092 @@
+/* A basic implementation of a statically allocated Doubly Linked List (DLL) buffer
+    An element can be added only at the tail, but can be removed from anywhere.
+
+    Every list is an instance of dll_buf_t over a node pool supplied by the caller, so any number of
+    lists with different element types and lengths can exist at the same time. Each node of the pool
+    is a dll_node_t (the index and the links) followed by the caller's element:
+
+     ___________________________________
+    |_IDX_|_NEXT_|_PREV_|_SAME_|____ELEMENT____|   Node size = DLL_NODE_SIZE(elem_size)
+
+    The functions work on elements of any size. DLL_BUF_DEFINE(name, type) generates functions for
+    one element type (name_add, name_remove) that move elements by assignment, so the compiler
+    copies a fixed size inline instead of calling memcpy. Copies only ever touch the element, never
+    the links of the node.
+
+    The pool is followed by an index from idx to node, an open addressing hash table with linear
+    probing and twice as many slots as nodes, so a conditional remove or a lookup finds its node in
+    constant time instead of walking the list. Every add and remove keeps it in sync.
+
+     ________________________________________
+    |_SLOT_|______|_SLOT_|_SLOT_|______|_SLOT_|   Index length = DLL_INDEX_LENGTH(length)
+       |              |
+       v              v
+     FIRST -SAME-> ... LAST                       Nodes with the same idx, oldest first
+
+    Any number of elements may have the same idx. The slot of an idx points to the oldest and the
+    newest node with it, and each node links to the next newer node with the same idx. A conditional
+    remove or a lookup always takes the oldest element with the idx, the first one from the head.
+
+    Optionally (dll_enable_slabs) the buffer does not become full but grows by slabs of nodes from the
+    allocator, linked on the end of the free chain when it runs dry, and the index doubles when the
+    nodes outgrow it. Nodes never move, so their addresses stay valid. dll_slab_trim returns the slabs
+    that have no node in use. Slab nodes have no tower in dll_skip.h, and a buffer that grows by slabs
+    cannot take part in dll_transfer or dll_split.
+
+     ______________      ______________________      ______________________
+    |_POOL_________| -> |_SLAB_|_NODE_|_NODE_|..| -> |_SLAB_|_NODE_|_NODE_|..|   free chain ... END
+      Supplied at init    Aligned to the slab size
+*/
+#ifndef DLL_H
+#define DLL_H
+
+/* Standard libarary includes */
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/* Counters and capture of the hot paths, compiled in with -DBUF_STATS and -DBUF_TRACE */
+#include "../Common/buf_stats.h"
+#include "../Common/buf_trace.h"
+
+/* Alignment of the slabs, at least a cache line */
+#define DLL_SLAB_ALIGN          64u
+
+/* Allocator of the slabs and grown indices, size is a multiple of the alignment */
+#ifndef DLL_SLAB_ALLOC
+#define DLL_SLAB_ALLOC(alignment, size) aligned_alloc((alignment), (size))
+#define DLL_SLAB_FREE(pointer)  free(pointer)
+#endif
+
+/* The links of one node in the pool, the element follows them */
+typedef struct dll_node_t
+{
+    int idx;
+    struct dll_node_t *next;
+    struct dll_node_t *prev;
+    struct dll_node_t *same;
+} dll_node_t;
+
+/* A slot of the index, empty when first is NULL */
+typedef struct
+{
+    dll_node_t *first;
+    dll_node_t *last;
+} dll_index_slot_t;
+
+/* Header of a slab of nodes, the nodes follow it */
+typedef struct dll_slab_t
+{
+    struct dll_slab_t *next;
+    int free_count;
+} dll_slab_t;
+
+/* Size of the header of a slab, the nodes start on the next cache line */
+#define DLL_SLAB_HEADER_SIZE    (((sizeof(dll_slab_t) + DLL_SLAB_ALIGN - 1u) / DLL_SLAB_ALIGN) * DLL_SLAB_ALIGN)
+
+/* Size of one node holding an element of elem_size bytes, elements may be aligned up to a pointer */
+#define DLL_NODE_SIZE(elem_size) \
+    ((sizeof(dll_node_t) + (elem_size) + (_Alignof(dll_node_t) - 1u)) & ~(_Alignof(dll_node_t) - 1u))
+
+/* Number of slots in the index for length elements, at most half of them are used */
+#define DLL_INDEX_LENGTH(length)                (2 * (length))
+
+/* Size of the node pool and index the caller must supply for length elements */
+#define DLL_STORAGE_SIZE(length, elem_size) \
+    (((size_t)(length) * DLL_NODE_SIZE(elem_size)) + ((size_t)DLL_INDEX_LENGTH(length) * sizeof(dll_index_slot_t)))
+
+/* DLL buffer structure declaration */
+typedef struct
+{
+    int length;
+    int alloc_count;
+    size_t elem_size;
+    size_t node_size;
+    unsigned char *pool;
+    dll_node_t *base;
+    dll_node_t *end;
+    dll_node_t *head;
+    dll_node_t *tail;
+    int index_length;
+    dll_index_slot_t *index;
+    /* Slab mode, off while slab_length is 0 */
+    int pool_length;
+    int slab_length;
+    int slab_watermark;
+    size_t slab_size;
+    dll_slab_t *slabs;
+    bool index_owned;
+} dll_buf_t;
+
+/* DLL buffer return code */
+typedef enum
+{
+    RC_DLLBUF_OK,
+    RC_DLLBUF_ERR_FULL,
+    RC_DLLBUF_ERR_EMPTY,
+    RC_DLLBUF_NOT_FOUND,
+    RC_DLLBUF_ERR_LENGTH,
+} dll_rc_t;
+
+/* Function called by dll_traverse for every element, from head to tail */
+typedef void (*dll_visit_t) (int idx, void *element);
+
+/* Function called by dll_remove_if for every element, returns true to remove it */
+typedef bool (*dll_match_t) (int idx, const void *element);
+
+/* Function to get the node at a position in the pool */
+static inline dll_node_t *dll_node (dll_buf_t *dll, int position)
+{
+    return (dll_node_t *)(dll->pool + ((size_t)position * dll->node_size));
+}
+
+/* Function to get the element stored in a node */
+static inline void *dll_payload (dll_node_t *node)
+{
+    return (void *)((unsigned char *)node + sizeof(dll_node_t));
+}
+
+/* Function to get the slot an idx hashes to, the multiply spreads nearby idx over the whole index */
+static inline int dll_index_home (dll_buf_t *dll, int idx)
+{
+    uint32_t hash = (uint32_t)idx * 0x9E3779B1u;
+    return (int)(((uint64_t)hash * (uint32_t)dll->index_length) >> 32);
+}
+
+/* Function to find the slot of an idx, or the empty slot where it would go
+    Only the probe steps of a lookup are counted, not those of the index keeping up with adds and removes.
+*/
+static inline dll_index_slot_t *dll_index_slot (dll_buf_t *dll, int idx, bool lookup)
+{
+    int position = dll_index_home(dll, idx);
+    dll_index_slot_t *slot = &dll->index[position];
+
+    /* At most half of the slots are used, so an empty slot always ends the probe */
+    while ((slot->first != NULL) && (slot->first->idx != idx))
+    {
+        position = ((position + 1) == dll->index_length) ? 0 : (position + 1);
+        slot = &dll->index[position];
+        if (lookup)
+        {
+            BUF_STAT_ADD(BUF_STATS_DLL, BUF_STAT_SCAN, 1u);
+        }
+    }
+    return slot;
+}
+
+/* Function to enter a newly added node in the index, after the other nodes with the same idx */
+static inline void dll_index_add (dll_buf_t *dll, dll_node_t *node)
+{
+    dll_index_slot_t *slot = dll_index_slot(dll, node->idx, false);
+
+    node->same = NULL;
+    if (slot->first == NULL)
+    {
+        slot->first = node;
+    }
+    else
+    {
+        slot->last->same = node;
+    }
+    slot->last = node;
+}
+
+/* Function to empty a slot, moving back the slots after it that would no longer be found
+    Linear probing without tombstones, so lookups never slow down after many removes.
+*/
+static inline void dll_index_clear (dll_buf_t *dll, dll_index_slot_t *slot)
+{
+    int hole = (int)(slot - dll->index);
+    int position = hole;
+
+    while (true)
+    {
+        position = ((position + 1) == dll->index_length) ? 0 : (position + 1);
+        dll_index_slot_t *next = &dll->index[position];
+        if (next->first == NULL)
+        {
+            break;
+        }
+        /* The slot stays if its home is cyclically between the hole and itself */
+        int home = dll_index_home(dll, next->first->idx);
+        bool stays = (hole <= position) ? ((hole < home) && (home <= position)) : ((hole < home) || (home <= position));
+        if (!stays)
+        {
+            dll->index[hole] = *next;
+            hole = position;
+        }
+    }
+    dll->index[hole].first = NULL;
+    dll->index[hole].last = NULL;
+}
+
+/* Function to take a removed node out of the index, the oldest node of an idx is found at once */
+static inline void dll_index_remove (dll_buf_t *dll, dll_node_t *node)
+{
+    dll_index_slot_t *slot = dll_index_slot(dll, node->idx, false);
+
+    if (slot->first == node)
+    {
+        slot->first = node->same;
+        if (slot->first == NULL)
+        {
+            dll_index_clear(dll, slot);
+        }
+    }
+    else
+    {
+        /* A newer node with the idx, walk the nodes with the same idx to the one before it */
+        dll_node_t *before = slot->first;
+        while (before->same != node)
+        {
+            before = before->same;
+        }
+        before->same = node->same;
+        if (slot->last == node)
+        {
+            slot->last = before;
+        }
+    }
+    node->same = NULL;
+}
+
+/* Function to find the oldest node with an idx, returns NULL if there is none */
+static inline dll_node_t *dll_find_node (dll_buf_t *dll, int idx)
+{
+    return dll_index_slot(dll, idx, true)->first;
+}
+
+/* Function to check if the DLL buffer is empty */
+static inline dll_rc_t dll_is_bufEmpty (dll_buf_t *dll)
+{
+    dll_rc_t rc = RC_DLLBUF_OK;
+
+    /* If the allocated count is 0, then the buffer is empty */
+    if (dll->alloc_count == 0)
+    {
+        rc = RC_DLLBUF_ERR_EMPTY;
+    }
+    return rc;
+}
+
+/* Function to check if the DLL buffer is full */
+static inline dll_rc_t dll_is_bufFull (dll_buf_t *dll)
+{
+    dll_rc_t rc = RC_DLLBUF_OK;
+
+    /* If the allocated count is the length, then the buffer is full */
+    if (dll->alloc_count == dll->length)
+    {
+        rc = RC_DLLBUF_ERR_FULL;
+    }
+    return rc;
+}
+
+/* Function to move the index to a table of index_length slots, when the list has grown past half of it */
+static inline bool dll_index_resize (dll_buf_t *dll, int index_length)
+{
+    dll_index_slot_t *old_index = dll->index;
+    int old_length = dll->index_length;
+    dll_index_slot_t *index = (dll_index_slot_t *)DLL_SLAB_ALLOC(sizeof(dll_index_slot_t), (size_t)index_length * sizeof(dll_index_slot_t));
+
+    if (index != NULL)
+    {
+        dll->index = index;
+        dll->index_length = index_length;
+        for (int i = 0; i < index_length; i++)
+        {
+            index[i].first = NULL;
+            index[i].last = NULL;
+        }
+        /* Every idx has one slot, so the slots move whole */
+        for (int i = 0; i < old_length; i++)
+        {
+            if (old_index[i].first != NULL)
+            {
+                *dll_index_slot(dll, old_index[i].first->idx, false) = old_index[i];
+            }
+        }
+        if (dll->index_owned)
+        {
+            DLL_SLAB_FREE(old_index);
+        }
+        dll->index_owned = true;
+    }
+    return (index != NULL);
+}
+
+/* Function to get the slab a node belongs to, or NULL for a node of the pool supplied at init */
+static inline dll_slab_t *dll_node_slab (dll_buf_t *dll, dll_node_t *node)
+{
+    dll_slab_t *slab = NULL;
+    unsigned char *address = (unsigned char *)node;
+
+    if ((address < dll->pool) || (address >= (dll->pool + ((size_t)dll->pool_length * dll->node_size))))
+    {
+        /* Slabs are aligned to their size, so the start of the slab is found by masking */
+        slab = (dll_slab_t *)((uintptr_t)address & ~((uintptr_t)dll->slab_size - 1u));
+    }
+    return slab;
+}
+
+/* Function to add a slab of nodes to the end of the free chain of a full buffer, returns false if out of memory */
+static inline bool dll_slab_grow (dll_buf_t *dll)
+{
+    bool grown = false;
+    dll_slab_t *slab = NULL;
+
+    /* Keep the index at most half used */
+    if ((DLL_INDEX_LENGTH(dll->length + dll->slab_length) <= dll->index_length) ||
+        dll_index_resize(dll, 2 * DLL_INDEX_LENGTH(dll->length + dll->slab_length)))
+    {
+        slab = (dll_slab_t *)DLL_SLAB_ALLOC(dll->slab_size, dll->slab_size);
+    }
+    if (slab != NULL)
+    {
+        unsigned char *nodes = (unsigned char *)slab + DLL_SLAB_HEADER_SIZE;
+
+        slab->next = dll->slabs;
+        dll->slabs = slab;
+        for (int i = 0; i < dll->slab_length; i++)
+        {
+            dll_node_t *node = (dll_node_t *)(nodes + ((size_t)i * dll->node_size));
+            node->prev = NULL;
+            node->next = ((i + 1) < dll->slab_length) ? (dll_node_t *)(nodes + ((size_t)(i + 1) * dll->node_size)) : NULL;
+        }
+        /* The buffer is full, so the end is the tail and the new nodes follow it */
+        dll->end->next = (dll_node_t *)nodes;
+        dll->end = (dll_node_t *)(nodes + ((size_t)(dll->slab_length - 1) * dll->node_size));
+        dll->length += dll->slab_length;
+        grown = true;
+    }
+    return grown;
+}
+
+/* Function to let the buffer grow by slabs of at least slab_length nodes instead of being full
+    Slabs are aligned to their size, a power of two, and filled with as many nodes as fit.
+    dll_slab_trim returns slabs with no node in use while more than free_watermark nodes are free.
+*/
+static inline void dll_enable_slabs (dll_buf_t *dll, int slab_length, int free_watermark)
+{
+    size_t slab_size = DLL_SLAB_ALIGN;
+
+    while (slab_size < (DLL_SLAB_HEADER_SIZE + ((size_t)slab_length * dll->node_size)))
+    {
+        slab_size *= 2u;
+    }
+    dll->slab_size = slab_size;
+    dll->slab_length = (int)((slab_size - DLL_SLAB_HEADER_SIZE) / dll->node_size);
+    dll->slab_watermark = free_watermark;
+}
+
+/* Function to return the slabs with no node in use to the allocator, keeping at least free_watermark free nodes
+    Takes one walk of the free chain, so it is called when the list has shrunk rather than on every remove.
+    Returns the number of slabs returned.
+*/
+static inline int dll_slab_trim (dll_buf_t *dll)
+{
+    /* The free chain starts at the tail of an empty list, whose node must stay */
+    dll_node_t *keep = (dll->alloc_count == 0) ? dll->tail : dll->tail->next;
+    dll_node_t *chain = (dll->alloc_count == 0) ? keep->next : keep;
+    int free_count = dll->length - dll->alloc_count;
+    int released = 0;
+
+    if (dll->alloc_count == 0)
+    {
+        free_count--;
+    }
+    /* Count the free nodes of each slab */
+    for (dll_slab_t *slab = dll->slabs; slab != NULL; slab = slab->next)
+    {
+        slab->free_count = 0;
+    }
+    for (dll_node_t *node = chain; node != NULL; node = node->next)
+    {
+        dll_slab_t *slab = dll_node_slab(dll, node);
+        if (slab != NULL)
+        {
+            slab->free_count++;
+        }
+    }
+    /* Mark the slabs to release while enough free nodes are left */
+    for (dll_slab_t *slab = dll->slabs; slab != NULL; slab = slab->next)
+    {
+        if ((slab->free_count == dll->slab_length) && ((free_count - dll->slab_length) >= dll->slab_watermark))
+        {
+            free_count -= dll->slab_length;
+            slab->free_count = -1;
+            released++;
+        }
+    }
+
+    if (released > 0)
+    {
+        /* Rebuild the free chain without the nodes of the released slabs */
+        dll_node_t *last = (dll->alloc_count == 0) ? keep : dll->tail;
+        for (dll_node_t *node = chain; node != NULL; node = node->next)
+        {
+            dll_slab_t *slab = dll_node_slab(dll, node);
+            if ((slab == NULL) || (slab->free_count >= 0))
+            {
+                last->next = node;
+                last = node;
+            }
+        }
+        last->next = NULL;
+        dll->end = last;
+
+        /* Return the marked slabs */
+        dll_slab_t **link = &dll->slabs;
+        while (*link != NULL)
+        {
+            dll_slab_t *slab = *link;
+            if (slab->free_count < 0)
+            {
+                *link = slab->next;
+                DLL_SLAB_FREE(slab);
+            }
+            else
+            {
+                link = &slab->next;
+            }
+        }
+        dll->length -= released * dll->slab_length;
+    }
+    return released;
+}
+
+/* Function to link a node at the tail, returns the node the element must be written to or NULL if full */
+static inline dll_node_t *dll_add_node (dll_buf_t *dll, int idx)
+{
+    dll_node_t *tail = NULL;
+    BUF_STAT_ADD(BUF_STATS_DLL, BUF_STAT_OPS, 1u);
+
+    /* Check if the buffer is full, and add a slab if it may grow */
+    if ((dll_is_bufFull(dll) == RC_DLLBUF_OK) || ((dll->slab_length > 0) && dll_slab_grow(dll)))
+    {
+        /* Get the tail */
+        tail = dll->tail;
+
+        /* Element will be added to tail always */
+        if (dll->alloc_count != 0)
+        {
+            /* There are elements present in queue */
+            /* Add the new element at the end of tail */
+            tail = tail->next;
+            /* Link the prev of newly added element to the old tail */
+            tail->prev = dll->tail;
+
+            /* Update the new tail */
+            dll->tail = tail;
+        }
+        tail->idx = idx;
+        dll_index_add(dll, tail);
+        dll->alloc_count++;
+    }
+    else
+    {
+        BUF_STAT_ADD(BUF_STATS_DLL, BUF_STAT_FULL, 1u);
+    }
+    return tail;
+}
+
+/* Funtion to add an element into the DLL buffer */
+static inline dll_rc_t dll_add (dll_buf_t *dll, int idx, const void *element)
+{
+    BUF_STAT_START(start);
+    dll_rc_t rc = RC_DLLBUF_ERR_FULL;
+    dll_node_t *node = dll_add_node(dll, idx);
+
+    if (node != NULL)
+    {
+        /* Copy the element */
+        (void) memcpy (dll_payload(node), element, dll->elem_size);
+        rc = RC_DLLBUF_OK;
+    }
+    BUF_STAT_STOP(BUF_STATS_DLL, start);
+    BUF_TRACE_OP(BUF_STATS_DLL, BUF_TRACE_ADD, idx, (rc != RC_DLLBUF_OK));
+    return rc;
+}
+
+/* Function to unlink a node in use and put it on the free chain */
+static inline void dll_unlink_node (dll_buf_t *dll, dll_node_t *node)
+{
+    dll_index_remove(dll, node);
+
+    if (dll->alloc_count > 1)
+    {
+        if (node == dll->head)
+        {
+            /* Move the head to the next pointing element */
+            dll->head = node->next;
+            /* De-link the previous of the head */
+            dll->head->prev = NULL;
+        }
+        else if (node == dll->tail)
+        {
+            /* Move the tail backward by one, the removed node is now the first free node after it */
+            dll->tail = node->prev;
+            node->prev = NULL;
+        }
+        else
+        {
+            node->prev->next = node->next;
+            node->next->prev = node->prev;
+        }
+
+        /* A removed tail already is the first free node after the new tail, others go to the end */
+        if (node != dll->tail->next)
+        {
+            /* De-link the prev and next removed element */
+            node->prev = node->next = NULL;
+            /* Link the previous end to the newly removed element */
+            dll->end->next = node;
+            /* Assign the end as the newly removed element */
+            dll->end = node;
+        }
+    }
+    /* The only element stays where it is as the node for the next add */
+    dll->alloc_count--;
+}
+
+/* Function to move a node in use to the tail, as if it was removed and added again without a copy
+    The nodes with the same idx keep the order they were added in.
+*/
+static inline void dll_move_to_tail (dll_buf_t *dll, dll_node_t *node)
+{
+    if (node != dll->tail)
+    {
+        /* Unlink the node, it is not the tail so it has a next */
+        if (node == dll->head)
+        {
+            dll->head = node->next;
+        }
+        else
+        {
+            node->prev->next = node->next;
+        }
+        node->next->prev = node->prev;
+
+        /* Link it between the tail and the first free node */
+        node->next = dll->tail->next;
+        node->prev = dll->tail;
+        dll->tail->next = node;
+        /* When full the end is the tail, the last node of the chain */
+        if (dll->end == dll->tail)
+        {
+            dll->end = node;
+        }
+        dll->tail = node;
+    }
+}
+
+/* Function to unlink a node, from the head in case of conventional remove or the oldest node with the index
+    Returns the removed node or NULL with the reason in rc. The removed node is put on the free chain,
+    so its element stays valid until the next element is added.
+*/
+static inline dll_node_t *dll_unlink (dll_buf_t *dll, bool conv_remove, int idx, dll_rc_t *rc)
+{
+    dll_node_t *removed = NULL;
+    BUF_STAT_ADD(BUF_STATS_DLL, BUF_STAT_OPS, 1u);
+
+    /* Check if the buffer is empty */
+    *rc = dll_is_bufEmpty(dll);
+
+    if (*rc == RC_DLLBUF_OK)
+    {
+        /* Remove the element from the head in case of conventional remove, else look the index up */
+        removed = conv_remove ? dll->head : dll_find_node(dll, idx);
+
+        if (removed != NULL)
+        {
+            dll_unlink_node(dll, removed);
+        }
+        else
+        {
+            *rc = RC_DLLBUF_NOT_FOUND;
+            BUF_STAT_ADD(BUF_STATS_DLL, BUF_STAT_NOT_FOUND, 1u);
+        }
+    }
+    else
+    {
+        BUF_STAT_ADD(BUF_STATS_DLL, BUF_STAT_EMPTY, 1u);
+    }
+    return removed;
+}
+
+/* Function to remove an element from the DLL buffer, from the head in case of conventional remove or by index */
+static inline dll_rc_t dll_remove (dll_buf_t *dll, void *element, bool conv_remove, int idx)
+{
+    BUF_STAT_START(start);
+    dll_rc_t rc;
+    dll_node_t *node = dll_unlink(dll, conv_remove, idx, &rc);
+
+    if (node != NULL)
+    {
+        (void) memcpy (element, dll_payload(node), dll->elem_size);
+    }
+    BUF_STAT_STOP(BUF_STATS_DLL, start);
+    BUF_TRACE_OP(BUF_STATS_DLL, conv_remove ? BUF_TRACE_REMOVE : BUF_TRACE_REMOVE_IDX, idx, (rc != RC_DLLBUF_OK));
+    return rc;
+}
+
+/* Function to unlink a run of nodes in use, from first to last, and take them out of the index
+    The run keeps its inner links and is not put on the free chain. Returns the number of nodes in it.
+*/
+static inline int dll_detach_run (dll_buf_t *dll, dll_node_t *first, dll_node_t *last)
+{
+    dll_node_t *prev = first->prev, *after = last->next;
+    int count = 0;
+
+    for (dll_node_t *node = first; ; node = node->next)
+    {
+        dll_index_remove(dll, node);
+        count++;
+        if (node == last)
+        {
+            break;
+        }
+    }
+
+    /* After the tail comes the free chain, so the next of the new tail is right either way */
+    if (prev != NULL)
+    {
+        prev->next = after;
+    }
+    else
+    {
+        dll->head = after;
+    }
+    if (last != dll->tail)
+    {
+        after->prev = prev;
+    }
+    else
+    {
+        dll->tail = prev;
+    }
+    /* When full the end is the tail, it moves back with the tail */
+    if (dll->end == last)
+    {
+        dll->end = dll->tail;
+    }
+    dll->alloc_count -= count;
+    if (dll->alloc_count == 0)
+    {
+        /* An empty list sits on its first free node, if there is one left */
+        dll->head = dll->tail = after;
+        if (after == NULL)
+        {
+            dll->end = NULL;
+        }
+        else
+        {
+            after->prev = NULL;
+        }
+    }
+    first->prev = NULL;
+    last->next = NULL;
+    return count;
+}
+
+/* Function to put a chain of unused nodes, linked by next, on the end of the free chain in one step */
+static inline void dll_append_free (dll_buf_t *dll, dll_node_t *first, dll_node_t *last)
+{
+    if (dll->head == NULL)
+    {
+        /* No node was left at all, the list sits on the first node of the chain */
+        dll->head = dll->tail = first;
+    }
+    else
+    {
+        dll->end->next = first;
+    }
+    dll->end = last;
+    last->next = NULL;
+}
+
+/* Function to remove in one pass every element the match function selects
+    The elements are copied to out in list order, unless out is NULL, and their nodes go on the end of
+    the free chain in one batch. Returns the number of elements removed.
+*/
+static inline int dll_remove_if (dll_buf_t *dll, dll_match_t match, void *out)
+{
+    dll_node_t *batch_first = NULL, *batch_last = NULL;
+    dll_node_t *node = dll->head;
+    int count = dll->alloc_count;
+    int removed = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        dll_node_t *next = node->next;
+        if (match(node->idx, dll_payload(node)))
+        {
+            if (out != NULL)
+            {
+                (void) memcpy ((unsigned char *)out + ((size_t)removed * dll->elem_size), dll_payload(node), dll->elem_size);
+            }
+            (void) dll_detach_run(dll, node, node);
+            /* Collect the node in the batch */
+            if (batch_first == NULL)
+            {
+                batch_first = node;
+            }
+            else
+            {
+                batch_last->next = node;
+            }
+            batch_last = node;
+            removed++;
+            /* Traced as a remove by idx, so a replay takes the same elements out */
+            BUF_TRACE_OP(BUF_STATS_DLL, BUF_TRACE_REMOVE_IDX, node->idx, false);
+        }
+        node = next;
+    }
+    if (batch_first != NULL)
+    {
+        dll_append_free(dll, batch_first, batch_last);
+    }
+    return removed;
+}
+
+/* Function to move the run of nodes from first to last after the node after, or to the head if after is NULL
+    Only links change, so it takes O(1) whatever the length of the run. The run and after must be in
+    the list, and after must not be in the run. The index keeps the order the elements were added in.
+*/
+static inline void dll_splice (dll_buf_t *dll, dll_node_t *first, dll_node_t *last, dll_node_t *after)
+{
+    if (first->prev != after)
+    {
+        dll_node_t *prev = first->prev, *next = last->next;
+
+        /* Close the gap the run leaves */
+        if (prev != NULL)
+        {
+            prev->next = next;
+        }
+        else
+        {
+            dll->head = next;
+        }
+        if (last != dll->tail)
+        {
+            next->prev = prev;
+        }
+        else
+        {
+            dll->tail = prev;
+        }
+
+        /* Link the run in its new place */
+        if (after == NULL)
+        {
+            last->next = dll->head;
+            dll->head->prev = last;
+            first->prev = NULL;
+            dll->head = first;
+        }
+        else
+        {
+            last->next = after->next;
+            if (after != dll->tail)
+            {
+                after->next->prev = last;
+            }
+            else
+            {
+                dll->tail = last;
+            }
+            after->next = first;
+            first->prev = after;
+        }
+        /* When full the end is the tail */
+        if (dll->alloc_count == dll->length)
+        {
+            dll->end = dll->tail;
+        }
+    }
+}
+
+/* Function to move the run of nodes from first to last in src to the tail of dst, without copying an element
+    Each buffer keeps as many nodes as its length, so dst hands the same number of its free nodes to
+    src. Both buffers then hold nodes of both pools, so from then on neither pool may be released or
+    reused while the other buffer is in use: both are de-initialized together. dst and src must be
+    different buffers. Slab nodes are found by the address of their pool, so neither buffer may grow
+    by slabs. Takes O(length of the run) for the index. Returns RC_DLLBUF_ERR_LENGTH if the element
+    sizes differ or a buffer grows by slabs, RC_DLLBUF_ERR_FULL if dst has too few free nodes.
+*/
+static inline dll_rc_t dll_transfer (dll_buf_t *dst, dll_buf_t *src, dll_node_t *first, dll_node_t *last)
+{
+    dll_rc_t rc = RC_DLLBUF_ERR_LENGTH;
+    int count = 1;
+
+    if ((dst->elem_size == src->elem_size) && (dst->slab_length == 0) && (src->slab_length == 0))
+    {
+        for (dll_node_t *node = first; node != last; node = node->next)
+        {
+            count++;
+        }
+        rc = ((dst->length - dst->alloc_count) >= count) ? RC_DLLBUF_OK : RC_DLLBUF_ERR_FULL;
+    }
+
+    if (rc == RC_DLLBUF_OK)
+    {
+        (void) dll_detach_run(src, first, last);
+
+        /* Take count free nodes of dst, the free chain starts at the tail of an empty list */
+        dll_node_t *free_first = (dst->alloc_count == 0) ? dst->tail : dst->tail->next;
+        dll_node_t *free_last = free_first;
+        for (int i = 1; i < count; i++)
+        {
+            free_last = free_last->next;
+        }
+        dll_node_t *rest = free_last->next;
+        dll_append_free(src, free_first, free_last);
+
+        /* Link the run after the tail of dst, followed by the free nodes dst has left */
+        if (dst->alloc_count == 0)
+        {
+            dst->head = first;
+        }
+        else
+        {
+            dst->tail->next = first;
+            first->prev = dst->tail;
+        }
+        last->next = rest;
+        dst->tail = last;
+        if (rest == NULL)
+        {
+            dst->end = last;
+        }
+        for (dll_node_t *node = first; node != rest; node = node->next)
+        {
+            dll_index_add(dst, node);
+        }
+        dst->alloc_count += count;
+    }
+    return rc;
+}
+
+/* Size of the index storage dll_split needs for a run of up to length nodes */
+#define DLL_SPLIT_STORAGE_SIZE(length)  ((size_t)DLL_INDEX_LENGTH(length) * sizeof(dll_index_slot_t))
+
+/* Function to split the run of nodes from first to last off src into dst, without copying an element
+    The nodes stay where they are: dst becomes a full buffer of the run, over the pool of src, and src
+    is shorter by as many nodes. Elements removed from dst free nodes for dst only. dst takes an index
+    over index_storage of DLL_SPLIT_STORAGE_SIZE(length) bytes for a run of at most length nodes, and is
+    de-initialized before src. Neither buffer may grow by slabs. Links change in O(1), the index takes
+    O(length of the run). Returns RC_DLLBUF_ERR_LENGTH if src grows by slabs, RC_DLLBUF_ERR_FULL if
+    the run is longer than length.
+*/
+static inline dll_rc_t dll_split (dll_buf_t *dst, void *index_storage, int length, dll_buf_t *src, dll_node_t *first, dll_node_t *last)
+{
+    dll_rc_t rc = RC_DLLBUF_ERR_LENGTH;
+    int count = 1;
+
+    if (src->slab_length == 0)
+    {
+        for (dll_node_t *node = first; node != last; node = node->next)
+        {
+            count++;
+        }
+        rc = (count <= length) ? RC_DLLBUF_OK : RC_DLLBUF_ERR_FULL;
+    }
+
+    if (rc == RC_DLLBUF_OK)
+    {
+        /* The run leaves src with its nodes, the free nodes of src stay */
+        (void) dll_detach_run(src, first, last);
+        src->length -= count;
+
+        /* dst is full with the run, so its end is its tail */
+        dst->length = count;
+        dst->alloc_count = count;
+        dst->elem_size = src->elem_size;
+        dst->node_size = src->node_size;
+        dst->pool = src->pool;
+        dst->pool_length = src->pool_length;
+        dst->base = first;
+        dst->head = first;
+        dst->tail = last;
+        dst->end = last;
+        dst->index_length = DLL_INDEX_LENGTH(length);
+        dst->index = (dll_index_slot_t *)index_storage;
+        for (int i = 0; i < dst->index_length; i++)
+        {
+            dst->index[i].first = NULL;
+            dst->index[i].last = NULL;
+        }
+        for (dll_node_t *node = first; node != NULL; node = node->next)
+        {
+            dll_index_add(dst, node);
+        }
+        dst->index_owned = false;
+        dst->slab_length = 0;
+        dst->slab_watermark = 0;
+        dst->slab_size = 0;
+        dst->slabs = NULL;
+    }
+    return rc;
+}
+
+/* Function to copy out the oldest element with an index without removing it */
+static inline dll_rc_t dll_find (dll_buf_t *dll, int idx, void *element)
+{
+    dll_rc_t rc = RC_DLLBUF_NOT_FOUND;
+    dll_node_t *node = dll_find_node(dll, idx);
+
+    if (node != NULL)
+    {
+        (void) memcpy (element, dll_payload(node), dll->elem_size);
+        rc = RC_DLLBUF_OK;
+    }
+    return rc;
+}
+
+static inline dll_rc_t dll_traverse (dll_buf_t *dll, dll_visit_t visit)
+{
+    /* Check if the buffer is empty */
+    dll_rc_t rc = dll_is_bufEmpty(dll);
+
+    if (rc == RC_DLLBUF_OK)
+    {
+        /* Always start from the head */
+        dll_node_t *traverse_var = dll->head, *tail = dll->tail;
+        do
+        {
+            /* Visit the index and element of nodes in the queue */
+            visit(traverse_var->idx, dll_payload(traverse_var));
+            traverse_var = traverse_var->next;
+        } while (traverse_var != tail->next);
+    }
+    return rc;
+}
+
+/* Initialize the DLL buffer over a caller supplied pool of DLL_STORAGE_SIZE(length, elem_size) bytes */
+static inline void dll_init (dll_buf_t *dll, void *storage, int length, size_t elem_size)
+{
+    /* Set the buffer size */
+    dll->length = length;
+    dll->elem_size = elem_size;
+    dll->node_size = DLL_NODE_SIZE(elem_size);
+    dll->pool = (unsigned char *)storage;
+    /* Initialize the allocated count */
+    dll->alloc_count = 0;
+    /* Make the base of the buffer point to the 0th node of the pool */
+    dll->base = dll_node(dll, 0);
+    /* Make the head and tail point to the base as the buffer is empty */
+    dll->tail = dll->head = dll->base;
+    /* Do not use the prev and next of the head tail and base */
+    dll->base->prev = NULL;
+    dll->base->next = NULL;
+
+    for (int i = 0; i < (dll->length - 1); i++)
+    {
+        /* Link all the nodes in the queue with next */
+        dll_node(dll, i)->next = dll_node(dll, i + 1);
+    }
+    /* Initialize the end of the queue as last node in the DLL */
+    dll->end = dll_node(dll, dll->length - 1);
+    /* Do not use the prev and next of the end, there is no element after end */
+    dll->end->prev = dll->end->next = NULL;
+
+    /* The index follows the node pool and starts with every slot empty */
+    dll->index_length = DLL_INDEX_LENGTH(length);
+    dll->index = (dll_index_slot_t *)(dll->pool + ((size_t)length * dll->node_size));
+    for (int i = 0; i < dll->index_length; i++)
+    {
+        dll->index[i].first = NULL;
+        dll->index[i].last = NULL;
+    }
+    dll->index_owned = false;
+
+    /* The buffer is full at length elements until dll_enable_slabs */
+    dll->pool_length = length;
+    dll->slab_length = 0;
+    dll->slab_watermark = 0;
+    dll->slab_size = 0;
+    dll->slabs = NULL;
+}
+
+/* De-Initialize the DLL buffer */
+static inline void dll_deInit (dll_buf_t *dll)
+{
+    /* Return the slabs and the grown index to the allocator */
+    while (dll->slabs != NULL)
+    {
+        dll_slab_t *slab = dll->slabs;
+        dll->slabs = slab->next;
+        DLL_SLAB_FREE(slab);
+    }
+    if (dll->index_owned)
+    {
+        DLL_SLAB_FREE(dll->index);
+        dll->index_owned = false;
+    }
+    dll->slab_length = 0;
+    /* Set the buffer size */
+    dll->length = 0;
+    /* Make the base of the buffer point to NULL */
+    dll->pool = NULL;
+    dll->base = NULL;
+    dll->index = NULL;
+    dll->index_length = 0;
+    /* Make the head and tail point to the NULL */
+    dll->tail = dll->head = dll->base;
+}
+
+/* Generate DLL functions for one element type: name_init, name_add, name_remove and name_find
+    Elements are moved by assignment, so the copy is a fixed size move the compiler can inline.
+    The storage for name_init is DLL_STORAGE_SIZE(length, sizeof(type)) bytes.
+*/
+#define DLL_BUF_DEFINE(name, type)                                                              \
+    _Static_assert(_Alignof(type) <= _Alignof(dll_node_t), "element alignment exceeds the node"); \
+    static inline void name##_init (dll_buf_t *dll, void *storage, int length)                 \
+    {                                                                                           \
+        dll_init(dll, storage, length, sizeof(type));                                           \
+    }                                                                                           \
+    static inline dll_rc_t name##_add (dll_buf_t *dll, int idx, const type *element)           \
+    {                                                                                           \
+        BUF_STAT_START(start);                                                                  \
+        dll_rc_t rc = RC_DLLBUF_ERR_FULL;                                                       \
+        dll_node_t *node = dll_add_node(dll, idx);                                              \
+        if (node != NULL)                                                                       \
+        {                                                                                       \
+            *(type *)dll_payload(node) = *element;                                              \
+            rc = RC_DLLBUF_OK;                                                                  \
+        }                                                                                       \
+        BUF_STAT_STOP(BUF_STATS_DLL, start);                                                    \
+        BUF_TRACE_OP(BUF_STATS_DLL, BUF_TRACE_ADD, idx, (rc != RC_DLLBUF_OK));                  \
+        return rc;                                                                              \
+    }                                                                                           \
+    static inline dll_rc_t name##_remove (dll_buf_t *dll, type *element, bool conv_remove, int idx) \
+    {                                                                                           \
+        BUF_STAT_START(start);                                                                  \
+        dll_rc_t rc;                                                                            \
+        dll_node_t *node = dll_unlink(dll, conv_remove, idx, &rc);                              \
+        if (node != NULL)                                                                       \
+        {                                                                                       \
+            *element = *(type *)dll_payload(node);                                              \
+        }                                                                                       \
+        BUF_STAT_STOP(BUF_STATS_DLL, start);                                                    \
+        BUF_TRACE_OP(BUF_STATS_DLL, conv_remove ? BUF_TRACE_REMOVE : BUF_TRACE_REMOVE_IDX,      \
+                     idx, (rc != RC_DLLBUF_OK));                                                \
+        return rc;                                                                              \
+    }                                                                                           \
+    static inline dll_rc_t name##_find (dll_buf_t *dll, int idx, type *element)               \
+    {                                                                                           \
+        dll_rc_t rc = RC_DLLBUF_NOT_FOUND;                                                      \
+        dll_node_t *node = dll_find_node(dll, idx);                                             \
+        if (node != NULL)                                                                       \
+        {                                                                                       \
+            *element = *(type *)dll_payload(node);                                              \
+            rc = RC_DLLBUF_OK;                                                                  \
+        }                                                                                       \
+        return rc;                                                                              \
+    }
+
+#endif /* DLL_H */
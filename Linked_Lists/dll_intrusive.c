@@ -0,0 +1,166 @@
+/* Demonstration of the intrusive DLL in dll_intrusive.h
+    Each task record embeds two links, so it is on a run queue and on the list of its owner at the
+    same time. The records stay in their own array and are never copied: a task removed from the run
+    queue is still on its owner's list, and the other way round.
+
+    Adding and removing a large record is then timed on the DLL buffer of dll.h, which copies it
+    into and out of its pool, and on the intrusive DLL, which only links it.
+*/
+
+/* Standard libarary includes */
+#include <stdio.h>
+#include <time.h>
+
+/* The counters of -DBUF_STATS and the trace of -DBUF_TRACE are defined in this file */
+#define BUF_STATS_IMPLEMENTATION
+#define BUF_TRACE_IMPLEMENTATION
+
+#include "dll_intrusive.h"
+
+/* Number of tasks and owners */
+#define TASK_COUNT              8
+#define OWNER_COUNT             2
+
+/* Size of the records and number of adds and removes timed */
+#define RECORD_SIZE             256
+#define BUFFER_LENGTH           1024
+#define ROUNDS                  1000
+
+/* The data organized in structure, with a link for each list */
+typedef struct
+{
+    int id;
+    int owner;
+    dll_link_t run_link;
+    dll_link_t owner_link;
+} task_t;
+
+/* A large record for the timing */
+typedef struct
+{
+    int id;
+    unsigned char payload[RECORD_SIZE - sizeof(int)];
+    dll_link_t link;
+} record_t;
+
+/* Static allocation of data is preferred */
+task_t tasks[TASK_COUNT];
+record_t records[BUFFER_LENGTH];
+_Alignas(dll_node_t) unsigned char data[DLL_STORAGE_SIZE(BUFFER_LENGTH, sizeof(record_t))];
+
+dll_list_t run_queue;
+dll_list_t owner_list[OWNER_COUNT];
+dll_list_t dll_list_ctrl;
+dll_buf_t dll_buf_ctrl;
+
+/* Function to match a task on the run queue by its id */
+bool run_id_match (const dll_link_t *link, const void *key)
+{
+    return (DLL_CONTAINER_OF(link, task_t, run_link)->id == *(const int *)key);
+}
+
+/* Functions to print a task from either of its links */
+void print_run (dll_link_t *link)
+{
+    printf ("[Task: %d] -> ", DLL_CONTAINER_OF(link, task_t, run_link)->id);
+}
+
+void print_owner (dll_link_t *link)
+{
+    printf ("[Task: %d] -> ", DLL_CONTAINER_OF(link, task_t, owner_link)->id);
+}
+
+/* Function to print the run queue and every owner's list */
+void print_lists (void)
+{
+    printf("Run queue:      ");
+    (void) dll_list_traverse(&run_queue, print_run);
+    printf("End\n");
+    for (int owner = 0; owner < OWNER_COUNT; owner++)
+    {
+        printf("Owner %d tasks:  ", owner);
+        (void) dll_list_traverse(&owner_list[owner], print_owner);
+        printf("End\n");
+    }
+}
+
+/* Function to get the time in nanoseconds */
+double now_ns (void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (time.tv_sec * 1e9) + time.tv_nsec;
+}
+
+int main()
+{
+    printf("\nIntrusive DLL Implementation. Tasks: %d, owners: %d\n", TASK_COUNT, OWNER_COUNT);
+    int id = 5;
+
+    dll_list_init(&run_queue);
+    for (int owner = 0; owner < OWNER_COUNT; owner++)
+    {
+        dll_list_init(&owner_list[owner]);
+    }
+    /* Put every task on the run queue and on its owner's list */
+    for (int i = 0; i < TASK_COUNT; i++)
+    {
+        tasks[i].id = i;
+        tasks[i].owner = i % OWNER_COUNT;
+        dll_list_add(&run_queue, &tasks[i].run_link);
+        dll_list_add(&owner_list[tasks[i].owner], &tasks[i].owner_link);
+    }
+    print_lists();
+
+    /* Run the task at the head, and take task 5 off the run queue only */
+    dll_link_t *link = dll_list_remove_head(&run_queue);
+    printf("\nRan task %d, took task %d off the run queue\n", DLL_CONTAINER_OF(link, task_t, run_link)->id,
+           DLL_CONTAINER_OF(dll_list_remove(&run_queue, run_id_match, &id), task_t, run_link)->id);
+    /* Task 2 leaves its owner but stays runnable */
+    dll_list_unlink(&owner_list[tasks[2].owner], &tasks[2].owner_link);
+    printf("Task 2 left owner %d\n", tasks[2].owner);
+    print_lists();
+
+    /* Time adding and removing the large records, copied by dll.h and linked by the intrusive DLL */
+    dll_init(&dll_buf_ctrl, data, BUFFER_LENGTH, sizeof(record_t));
+    dll_list_init(&dll_list_ctrl);
+    double copy_ns = 0.0, link_ns = 0.0, start;
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        start = now_ns();
+        for (int i = 0; i < BUFFER_LENGTH; i++)
+        {
+            records[i].id = i;
+            (void) dll_add(&dll_buf_ctrl, i, &records[i]);
+        }
+        for (int i = 0; i < BUFFER_LENGTH; i++)
+        {
+            (void) dll_remove(&dll_buf_ctrl, &records[i], true, 0);
+        }
+        copy_ns += now_ns() - start;
+
+        start = now_ns();
+        for (int i = 0; i < BUFFER_LENGTH; i++)
+        {
+            records[i].id = i;
+            dll_list_add(&dll_list_ctrl, &records[i].link);
+        }
+        for (int i = 0; i < BUFFER_LENGTH; i++)
+        {
+            (void) dll_list_remove_head(&dll_list_ctrl);
+        }
+        link_ns += now_ns() - start;
+    }
+    printf("\nAdd and remove of a %d byte record: copied %.1f ns, linked %.1f ns\n", RECORD_SIZE,
+           copy_ns / ((double)ROUNDS * BUFFER_LENGTH), link_ns / ((double)ROUNDS * BUFFER_LENGTH));
+
+    dll_deInit(&dll_buf_ctrl);
+    dll_list_deInit(&dll_list_ctrl);
+    dll_list_deInit(&run_queue);
+    for (int owner = 0; owner < OWNER_COUNT; owner++)
+    {
+        dll_list_deInit(&owner_list[owner]);
+    }
+    printf("\nExited program");
+    return 0;
+}
@@ -0,0 +1,203 @@
+/* An intrusive Doubly Linked List (DLL), the links live inside the caller's own records
+    An element can be added only at the tail, but can be removed from anywhere, as in dll.h.
+
+    dll.h copies every element into a node of its pool. Here the caller embeds a dll_link_t in its
+    record instead, and the list links the records themselves, wherever they live: nothing is copied
+    on an add or a remove, and the list holds no storage of its own.
+
+     ____________________________________      ____________________________________
+    |_DATA_|_LINK_|_DATA_|_LINK_|_DATA_|..|    |_DATA_|_LINK_|_DATA_|_LINK_|_DATA_|..|   Caller's records
+              |  ^         |                             |  ^
+     HEAD ----+  +---------+--- ... TAIL        HEAD ----+  +--- ... TAIL             Two lists
+
+    A record with a dll_link_t member for each list can be on several lists at the same time, such as
+    a run queue and a list per owner. DLL_CONTAINER_OF gets the record back from its link.
+    A link must be on one list at a time, and the record must stay where it is while it is linked.
+*/
+#ifndef DLL_INTRUSIVE_H
+#define DLL_INTRUSIVE_H
+
+/* Standard libarary includes */
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/* The return codes are shared with the basic DLL buffer */
+#include "dll.h"
+
+/* Function to get the record holding a link, from the type of the record and the name of the member */
+#define DLL_CONTAINER_OF(link, type, member) \
+    ((type *)((unsigned char *)(link) - offsetof(type, member)))
+
+/* The links the caller embeds in its record, one for each list the record can be on */
+typedef struct dll_link_t
+{
+    struct dll_link_t *next;
+    struct dll_link_t *prev;
+} dll_link_t;
+
+/* Intrusive DLL structure declaration */
+typedef struct
+{
+    int count;
+    dll_link_t *head;
+    dll_link_t *tail;
+} dll_list_t;
+
+/* Function called for each link of a traversal */
+typedef void (*dll_link_visit_t)(dll_link_t *link);
+
+/* Function to select the links of a search or a remove, true for a match */
+typedef bool (*dll_link_match_t)(const dll_link_t *link, const void *key);
+
+/* Function to check if the intrusive DLL is empty */
+static inline dll_rc_t dll_list_is_empty (dll_list_t *list)
+{
+    dll_rc_t rc = RC_DLLBUF_OK;
+
+    /* If the count is 0, then the list is empty */
+    if (list->count == 0)
+    {
+        rc = RC_DLLBUF_ERR_EMPTY;
+    }
+    return rc;
+}
+
+/* Funtion to link a record at the tail of the intrusive DLL */
+static inline void dll_list_add (dll_list_t *list, dll_link_t *link)
+{
+    link->next = NULL;
+    link->prev = list->tail;
+    if (list->tail != NULL)
+    {
+        list->tail->next = link;
+    }
+    else
+    {
+        /* The first record is also the head */
+        list->head = link;
+    }
+    list->tail = link;
+    list->count++;
+}
+
+/* Funtion to link a record after a linked one, or at the head if after is NULL */
+static inline void dll_list_insert_after (dll_list_t *list, dll_link_t *after, dll_link_t *link)
+{
+    dll_link_t *next = (after != NULL) ? after->next : list->head;
+
+    link->prev = after;
+    link->next = next;
+    if (after != NULL)
+    {
+        after->next = link;
+    }
+    else
+    {
+        list->head = link;
+    }
+    if (next != NULL)
+    {
+        next->prev = link;
+    }
+    else
+    {
+        list->tail = link;
+    }
+    list->count++;
+}
+
+/* Function to unlink a record from anywhere in the intrusive DLL, in O(1) */
+static inline void dll_list_unlink (dll_list_t *list, dll_link_t *link)
+{
+    if (link->prev != NULL)
+    {
+        link->prev->next = link->next;
+    }
+    else
+    {
+        list->head = link->next;
+    }
+    if (link->next != NULL)
+    {
+        link->next->prev = link->prev;
+    }
+    else
+    {
+        list->tail = link->prev;
+    }
+    /* De-link the prev and next of the removed record */
+    link->prev = link->next = NULL;
+    list->count--;
+}
+
+/* Function to unlink the record at the head, returns NULL if the list is empty */
+static inline dll_link_t *dll_list_remove_head (dll_list_t *list)
+{
+    dll_link_t *link = list->head;
+
+    if (link != NULL)
+    {
+        dll_list_unlink(list, link);
+    }
+    return link;
+}
+
+/* Function to find the first link from the head that matches key, returns NULL if there is none */
+static inline dll_link_t *dll_list_find (dll_list_t *list, dll_link_match_t match, const void *key)
+{
+    dll_link_t *link = list->head;
+
+    while ((link != NULL) && (!match(link, key)))
+    {
+        link = link->next;
+    }
+    return link;
+}
+
+/* Function to unlink the first record from the head that matches key, returns NULL if there is none */
+static inline dll_link_t *dll_list_remove (dll_list_t *list, dll_link_match_t match, const void *key)
+{
+    dll_link_t *link = dll_list_find(list, match, key);
+
+    if (link != NULL)
+    {
+        dll_list_unlink(list, link);
+    }
+    return link;
+}
+
+/* Function to traverse through the intrusive DLL, from head to tail */
+static inline dll_rc_t dll_list_traverse (dll_list_t *list, dll_link_visit_t visit)
+{
+    /* Check if the list is empty */
+    dll_rc_t rc = dll_list_is_empty(list);
+
+    if (rc == RC_DLLBUF_OK)
+    {
+        /* Take the next link first, so the visit may unlink the record */
+        for (dll_link_t *link = list->head, *next; link != NULL; link = next)
+        {
+            next = link->next;
+            visit(link);
+        }
+    }
+    return rc;
+}
+
+/* Initialize the intrusive DLL, empty */
+static inline void dll_list_init (dll_list_t *list)
+{
+    list->count = 0;
+    list->head = list->tail = NULL;
+}
+
+/* De-Initialize the intrusive DLL, the records are left to the caller */
+static inline void dll_list_deInit (dll_list_t *list)
+{
+    list->count = 0;
+    list->head = list->tail = NULL;
+}
+
+#endif /* DLL_INTRUSIVE_H */
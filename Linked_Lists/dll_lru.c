@@ -0,0 +1,113 @@
+/* Demonstration of the LRU cache in dll_lru.h
+    The cache sits in front of a slow lookup. Keys are requested with a skewed distribution, a few
+    keys often and many keys rarely, so most requests hit the cache even though it holds only a
+    small part of the keys. Every value read from the cache is checked against the slow lookup.
+*/
+
+/* Standard libarary includes */
+#include <stdio.h>
+#include <stdlib.h>
+
+/* The counters of -DBUF_STATS and the trace of -DBUF_TRACE are defined in this file */
+#define BUF_STATS_IMPLEMENTATION
+#define BUF_TRACE_IMPLEMENTATION
+
+#include "dll_lru.h"
+
+/* Number of entries the cache holds */
+#define CACHE_CAPACITY          256
+
+/* Number of different keys and requests made */
+#define KEY_COUNT               10000
+#define REQUEST_COUNT           1000000
+
+/* The data organized in structure */
+typedef struct
+{
+    int key;
+    int value;
+} data_t;
+
+/* Static allocation of data is preferred */
+_Alignas(dll_node_t) unsigned char data[DLL_LRU_STORAGE_SIZE(CACHE_CAPACITY, sizeof(data_t))];
+
+dll_lru_t dll_lru_ctrl;
+
+/* Function standing in for a slow lookup, such as a database or a file */
+data_t slow_lookup (int key)
+{
+    data_t element = { .key = key, .value = key * 7 };
+    return element;
+}
+
+/* Function to pick a key, small keys are requested far more often */
+int pick_key (void)
+{
+    double uniform = (double)rand() / ((double)RAND_MAX + 1.0);
+    return (int)(KEY_COUNT * uniform * uniform * uniform * uniform * uniform * uniform);
+}
+
+/* Function to print an entry of the cache */
+void print_element (int idx, void *element)
+{
+    printf ("[Key: %d, Value: %d] -> ", idx, ((data_t *)element)->value);
+}
+
+int main()
+{
+    printf("\nLRU Cache Implementation. Capacity: %d, keys: %d\n", CACHE_CAPACITY, KEY_COUNT);
+    data_t element;
+    dll_lru_stats_t stats;
+    int errors = 0;
+
+    dll_lru_init(&dll_lru_ctrl, data, CACHE_CAPACITY, sizeof(data_t));
+    srand(1);
+
+    for (int i = 0; i < REQUEST_COUNT; i++)
+    {
+        int key = pick_key();
+        if (dll_lru_get(&dll_lru_ctrl, key, &element) == RC_DLLBUF_OK)
+        {
+            /* A hit must match the slow lookup */
+            if ((element.key != key) || (element.value != slow_lookup(key).value))
+            {
+                errors++;
+            }
+        }
+        else
+        {
+            element = slow_lookup(key);
+            (void) dll_lru_put(&dll_lru_ctrl, key, &element);
+        }
+    }
+
+    dll_lru_get_stats(&dll_lru_ctrl, &stats);
+    printf("Hits: %llu, misses: %llu, evictions: %llu, hit rate %.1f %%, %d wrong values\n",
+           stats.hits, stats.misses, stats.evictions, (100.0 * stats.hits) / (stats.hits + stats.misses), errors);
+
+    /* Drop key 0 and put keys 3 to 0 last, so key 0 ends as the most recently used */
+    (void) dll_lru_erase(&dll_lru_ctrl, 0);
+    for (int key = 3; key >= 0; key--)
+    {
+        element = slow_lookup(key);
+        (void) dll_lru_put(&dll_lru_ctrl, key, &element);
+    }
+    int key = 0;
+    printf("\nEvicting the 4 least recently used entries:\n");
+    for (int i = 0; i < 4; i++)
+    {
+        (void) dll_lru_evict(&dll_lru_ctrl, &key, &element);
+        printf ("[Key: %d, Value: %d] ", key, element.value);
+    }
+    printf("\nMost recently used entries, newest first: ");
+    dll_node_t *node = dll_lru_ctrl.list.tail;
+    for (int i = 0; i < 4; i++, node = node->prev)
+    {
+        print_element(node->idx, dll_payload(node));
+    }
+    printf("End\n");
+
+    dll_lru_deInit(&dll_lru_ctrl);
+    printf("\nExited program");
+    return 0;
+}
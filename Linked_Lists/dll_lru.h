@@ -0,0 +1,172 @@
+/* A fixed capacity LRU cache built on the Doubly Linked List (DLL) buffer
+
+    The cache is a dll_buf_t ordered by use: the head is the least recently used entry and the tail
+    the most recently used one. The key of an entry is the idx of its node, so the index of the DLL
+    finds it in constant time.
+
+     ______     ______     ______     ______
+    |_KEY__|-->|_KEY__|-->|_KEY__|-->|_KEY__|-->  free nodes ... END
+     HEAD                             TAIL
+     least recently used              most recently used
+
+    Get:   look the key up, and on a hit move its node to the tail.
+    Put:   update the entry of the key and move it to the tail, or add a new entry at the tail.
+           When the cache is full, the head is removed first and its node goes straight onto the
+           free chain, where the new entry takes it. Nothing is allocated or copied besides the value.
+
+    Hits, misses and evictions are counted with relaxed atomic stores, so another thread can read
+    them with dll_lru_get_stats while the cache is used by its own thread.
+*/
+#ifndef DLL_LRU_H
+#define DLL_LRU_H
+
+/* Standard libarary includes */
+#include <stdio.h>
+#include <string.h>
+#include <stdatomic.h>
+
+/* The cache is a DLL buffer */
+#include "dll.h"
+
+/* Size of the storage the caller must supply for capacity entries */
+#define DLL_LRU_STORAGE_SIZE(capacity, elem_size)   DLL_STORAGE_SIZE(capacity, elem_size)
+
+/* Counters of the cache */
+typedef struct
+{
+    atomic_ullong hits;
+    atomic_ullong misses;
+    atomic_ullong evictions;
+} dll_lru_counters_t;
+
+/* Snapshot of the counters returned by dll_lru_get_stats */
+typedef struct
+{
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long evictions;
+} dll_lru_stats_t;
+
+/* LRU cache structure declaration */
+typedef struct
+{
+    dll_buf_t list;
+    dll_lru_counters_t stats;
+} dll_lru_t;
+
+/* Function to add to a counter, only the thread using the cache writes it */
+static inline void dll_lru_stat_add (atomic_ullong *counter, unsigned long long value)
+{
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + value, memory_order_relaxed);
+}
+
+/* Function to remove the least recently used entry, its node goes onto the free chain */
+static inline dll_rc_t dll_lru_evict (dll_lru_t *lru, int *key, void *value)
+{
+    dll_rc_t rc;
+    dll_node_t *node = dll_unlink(&lru->list, true, 0, &rc);
+
+    if (node != NULL)
+    {
+        *key = node->idx;
+        (void) memcpy (value, dll_payload(node), lru->list.elem_size);
+        dll_lru_stat_add(&lru->stats.evictions, 1u);
+    }
+    return rc;
+}
+
+/* Function to look a key up, a hit copies the value out and makes the entry the most recently used */
+static inline dll_rc_t dll_lru_get (dll_lru_t *lru, int key, void *value)
+{
+    dll_rc_t rc = RC_DLLBUF_NOT_FOUND;
+    dll_node_t *node = dll_find_node(&lru->list, key);
+
+    if (node != NULL)
+    {
+        dll_move_to_tail(&lru->list, node);
+        (void) memcpy (value, dll_payload(node), lru->list.elem_size);
+        dll_lru_stat_add(&lru->stats.hits, 1u);
+        rc = RC_DLLBUF_OK;
+    }
+    else
+    {
+        dll_lru_stat_add(&lru->stats.misses, 1u);
+    }
+    return rc;
+}
+
+/* Function to store the value of a key as the most recently used entry, evicting the least recently used one if full */
+static inline dll_rc_t dll_lru_put (dll_lru_t *lru, int key, const void *value)
+{
+    dll_rc_t rc = RC_DLLBUF_OK;
+    dll_node_t *node = dll_find_node(&lru->list, key);
+
+    if (node != NULL)
+    {
+        /* Already cached, update it in place */
+        dll_move_to_tail(&lru->list, node);
+    }
+    else
+    {
+        if (dll_is_bufFull(&lru->list) != RC_DLLBUF_OK)
+        {
+            /* Recycle the least recently used node, the value is dropped */
+            (void) dll_unlink(&lru->list, true, 0, &rc);
+            dll_lru_stat_add(&lru->stats.evictions, 1u);
+        }
+        node = dll_add_node(&lru->list, key);
+    }
+    if (node != NULL)
+    {
+        (void) memcpy (dll_payload(node), value, lru->list.elem_size);
+    }
+    else
+    {
+        /* Only when the cache has no capacity */
+        rc = RC_DLLBUF_ERR_FULL;
+    }
+    return rc;
+}
+
+/* Function to drop the entry of a key, when the value it caches has changed */
+static inline dll_rc_t dll_lru_erase (dll_lru_t *lru, int key)
+{
+    dll_rc_t rc = RC_DLLBUF_NOT_FOUND;
+
+    if (dll_find_node(&lru->list, key) != NULL)
+    {
+        (void) dll_unlink(&lru->list, false, key, &rc);
+    }
+    return rc;
+}
+
+/* Function to reset the counters of the cache */
+static inline void dll_lru_reset_stats (dll_lru_t *lru)
+{
+    atomic_store_explicit(&lru->stats.hits, 0u, memory_order_relaxed);
+    atomic_store_explicit(&lru->stats.misses, 0u, memory_order_relaxed);
+    atomic_store_explicit(&lru->stats.evictions, 0u, memory_order_relaxed);
+}
+
+/* Function to read the counters of the cache, safe to call from any thread while the cache is in use */
+static inline void dll_lru_get_stats (dll_lru_t *lru, dll_lru_stats_t *stats)
+{
+    stats->hits = atomic_load_explicit(&lru->stats.hits, memory_order_relaxed);
+    stats->misses = atomic_load_explicit(&lru->stats.misses, memory_order_relaxed);
+    stats->evictions = atomic_load_explicit(&lru->stats.evictions, memory_order_relaxed);
+}
+
+/* Initialize the LRU cache over caller supplied storage of DLL_LRU_STORAGE_SIZE(capacity, elem_size) bytes */
+static inline void dll_lru_init (dll_lru_t *lru, void *storage, int capacity, size_t elem_size)
+{
+    dll_init(&lru->list, storage, capacity, elem_size);
+    dll_lru_reset_stats(lru);
+}
+
+/* De-Initialize the LRU cache */
+static inline void dll_lru_deInit (dll_lru_t *lru)
+{
+    dll_deInit(&lru->list);
+}
+
+#endif /* DLL_LRU_H */
@@ -0,0 +1,194 @@
+/* Demonstration of the concurrent DLL buffer in dll_rcu.h
+    One writer thread keeps removing elements from anywhere in the list and adding new ones at the
+    tail, while 1, 2, 4 and 8 reader threads walk the whole list over and over. The same work is run
+    on the DLL buffer of dll.h behind a global lock.
+
+    Each element holds its index and three times its index, so a reader seeing a node that was reused
+    while it was on it counts an error.
+*/
+
+/* Standard libarary includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+
+/* The counters of -DBUF_STATS and the trace of -DBUF_TRACE are defined in this file */
+#define BUF_STATS_IMPLEMENTATION
+#define BUF_TRACE_IMPLEMENTATION
+
+#include "dll_rcu.h"
+
+/* Buffer size, and the number of elements kept in the list */
+#define BUFFER_LENGTH           1024
+#define LIST_LENGTH             512
+
+/* Time each run lasts */
+#define RUN_MS                  500
+
+/* Largest number of readers */
+#define MAX_READERS             8
+
+/* The data organized in structure */
+typedef struct
+{
+    int idx;
+    int data;
+} data_t;
+
+/* Static allocation of data is preferred */
+_Alignas(max_align_t) unsigned char data[DLL_RCU_STORAGE_SIZE(BUFFER_LENGTH, sizeof(data_t))];
+_Alignas(dll_node_t) unsigned char locked_data[DLL_STORAGE_SIZE(BUFFER_LENGTH, sizeof(data_t))];
+
+dll_rcu_t dll_rcu_ctrl;
+
+/* The list behind a global lock it is compared with */
+dll_buf_t dll_buf_ctrl;
+pthread_mutex_t dll_buf_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Set when the run is over */
+atomic_bool stop;
+
+/* Work counted by one reader */
+typedef struct
+{
+    bool locked;
+    long long walks;
+    long long errors;
+} reader_t;
+
+/* Errors seen by the visit function of the calling reader */
+_Thread_local long long visit_errors;
+
+void check_element (int idx, void *element)
+{
+    data_t *value = (data_t *)element;
+    if ((value->idx != idx) || (value->data != (3 * idx)))
+    {
+        visit_errors++;
+    }
+}
+
+void *reader (void *arg)
+{
+    reader_t *work = (reader_t *)arg;
+    int number = work->locked ? 0 : dll_rcu_register(&dll_rcu_ctrl);
+
+    if (number < 0)
+    {
+        /* No free reader slot, count it and stay out of the run */
+        work->errors = 1;
+        return arg;
+    }
+    visit_errors = 0;
+    while (!atomic_load_explicit(&stop, memory_order_relaxed))
+    {
+        if (work->locked)
+        {
+            pthread_mutex_lock(&dll_buf_lock);
+            (void) dll_traverse(&dll_buf_ctrl, check_element);
+            pthread_mutex_unlock(&dll_buf_lock);
+        }
+        else
+        {
+            (void) dll_rcu_traverse(&dll_rcu_ctrl, number, check_element);
+        }
+        work->walks++;
+    }
+    work->errors = visit_errors;
+    if (!work->locked)
+    {
+        dll_rcu_unregister(&dll_rcu_ctrl, number);
+    }
+    return arg;
+}
+
+void *writer (void *arg)
+{
+    bool locked = *(bool *)arg;
+    data_t element;
+    int next_idx = LIST_LENGTH;
+
+    while (!atomic_load_explicit(&stop, memory_order_relaxed))
+    {
+        /* Replace a random recent element with a new one at the tail */
+        int idx = next_idx - 1 - (rand() % LIST_LENGTH);
+        element.idx = next_idx;
+        element.data = 3 * next_idx;
+        if (locked)
+        {
+            pthread_mutex_lock(&dll_buf_lock);
+            (void) dll_remove(&dll_buf_ctrl, &element, false, idx);
+            element.idx = next_idx;
+            element.data = 3 * next_idx;
+            (void) dll_add(&dll_buf_ctrl, element.idx, &element);
+            pthread_mutex_unlock(&dll_buf_lock);
+        }
+        else
+        {
+            data_t removed;
+            (void) dll_rcu_remove(&dll_rcu_ctrl, &removed, false, idx);
+            (void) dll_rcu_add(&dll_rcu_ctrl, element.idx, &element);
+        }
+        next_idx++;
+    }
+    return arg;
+}
+
+/* Function to run the readers and the writer for RUN_MS */
+void timed_run (bool locked, int reader_count)
+{
+    pthread_t threads[MAX_READERS], writer_thread;
+    reader_t readers[MAX_READERS];
+    struct timespec run = { .tv_sec = RUN_MS / 1000, .tv_nsec = (RUN_MS % 1000) * 1000000L };
+    data_t element;
+    long long walks = 0, errors = 0;
+
+    /* Fill both lists */
+    dll_rcu_init(&dll_rcu_ctrl, data, BUFFER_LENGTH, sizeof(data_t));
+    dll_init(&dll_buf_ctrl, locked_data, BUFFER_LENGTH, sizeof(data_t));
+    for (int i = 0; i < LIST_LENGTH; i++)
+    {
+        element.idx = i;
+        element.data = 3 * i;
+        (void) dll_rcu_add(&dll_rcu_ctrl, i, &element);
+        (void) dll_add(&dll_buf_ctrl, i, &element);
+    }
+
+    atomic_store(&stop, false);
+    for (int i = 0; i < reader_count; i++)
+    {
+        readers[i] = (reader_t){ .locked = locked, .walks = 0, .errors = 0 };
+        pthread_create(&threads[i], NULL, reader, &readers[i]);
+    }
+    pthread_create(&writer_thread, NULL, writer, &locked);
+    nanosleep(&run, NULL);
+    atomic_store(&stop, true);
+    pthread_join(writer_thread, NULL);
+    for (int i = 0; i < reader_count; i++)
+    {
+        pthread_join(threads[i], NULL);
+        walks += readers[i].walks;
+        errors += readers[i].errors;
+    }
+
+    printf("%d readers, %-12s %8.0f walks/s of %d elements, %lld errors\n", reader_count,
+           locked ? "global lock:" : "lock-free:", walks / (RUN_MS / 1000.0), LIST_LENGTH, errors);
+
+    dll_rcu_deInit(&dll_rcu_ctrl);
+    dll_deInit(&dll_buf_ctrl);
+}
+
+int main()
+{
+    printf("\nConcurrent DLL Buffer Implementation. Length of buffer: %d, elements in the list: %d\n", BUFFER_LENGTH, LIST_LENGTH);
+
+    for (int reader_count = 1; reader_count <= MAX_READERS; reader_count *= 2)
+    {
+        timed_run(true, reader_count);
+        timed_run(false, reader_count);
+    }
+
+    printf("\nExited program");
+    return 0;
+}
@@ -0,0 +1,374 @@
+/* A Doubly Linked List (DLL) buffer for one writer and many lock-free readers (RCU-style)
+    An element can be added only at the tail, but can be removed from anywhere, as in dll.h.
+
+    Readers walk the list from the head without taking a lock and without writing any shared cache
+    line. Only the writer changes the list, and it publishes every change of a next link or the head
+    with a release store, after the node it links in is completely written:
+
+     ______     ______     ______
+    |_NODE_|-->|_NODE_|-->|_NODE_|--> NULL         the list, read by everyone
+     HEAD        |         TAIL
+                 v
+     ______     ______
+    |_NODE_|-->|_NODE_|                            retired nodes, a reader may still be on them
+     ______     ______     ______
+    |_NODE_|-->|_NODE_|-->|_NODE_|                 free chain, up to the END
+     FREE                   END
+
+    A removed node is unlinked, but its own next link is left as it is, so a reader standing on it
+    still reaches the rest of the list. The node is retired, and goes back on the end of the free
+    chain only after a grace period: once every reader that was inside a read section when it was
+    unlinked has left that section. Nodes are reclaimed in a batch when the free chain runs dry, so
+    one grace period covers every node removed since the last one.
+
+    Each reader announces its read sections in a sequence number on its own cache line, odd while
+    inside. The writer waits for a grace period by waiting for every odd sequence number it sees to
+    change. Readers never wait, and read sections must not be nested. A reader thread claims one of
+    DLL_RCU_MAX_READERS slots with dll_rcu_register and gives it back with dll_rcu_unregister, so
+    threads can come and go for as long as no more than that many are registered at once.
+*/
+#ifndef DLL_RCU_H
+#define DLL_RCU_H
+
+/* Standard libarary includes */
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <sched.h>
+
+/* The return codes and the visit function are shared with the basic DLL buffer */
+#include "dll.h"
+
+/* Size of a cache line, used to keep the readers apart */
+#define DLL_RCU_CACHE_LINE      64
+
+/* Largest number of readers */
+#ifndef DLL_RCU_MAX_READERS
+#define DLL_RCU_MAX_READERS     64
+#endif
+
+/* The links of one node in the pool, the element follows them */
+typedef struct dll_rcu_node_t
+{
+    int idx;
+    _Atomic(struct dll_rcu_node_t *) next;
+    /* Only used by the writer */
+    struct dll_rcu_node_t *prev;
+} dll_rcu_node_t;
+
+/* Size of one node holding an element of elem_size bytes */
+#define DLL_RCU_NODE_SIZE(elem_size) \
+    ((sizeof(dll_rcu_node_t) + (elem_size) + (_Alignof(max_align_t) - 1u)) & ~(_Alignof(max_align_t) - 1u))
+
+/* Size of the node pool the caller must supply for length elements */
+#define DLL_RCU_STORAGE_SIZE(length, elem_size)     ((size_t)(length) * DLL_RCU_NODE_SIZE(elem_size))
+
+/* Read section sequence number of one reader, odd while inside, and whether a thread holds the slot */
+typedef struct
+{
+    _Alignas(DLL_RCU_CACHE_LINE) atomic_ullong seq;
+    atomic_bool in_use;
+} dll_rcu_reader_t;
+
+/* Concurrent DLL buffer structure declaration */
+typedef struct
+{
+    /* Read by everyone */
+    _Alignas(DLL_RCU_CACHE_LINE) _Atomic(dll_rcu_node_t *) head;
+
+    /* Only used by the writer */
+    _Alignas(DLL_RCU_CACHE_LINE) int length;
+    int alloc_count;
+    size_t elem_size;
+    size_t node_size;
+    unsigned char *pool;
+    dll_rcu_node_t *tail;
+    dll_rcu_node_t *free;
+    dll_rcu_node_t *end;
+    dll_rcu_node_t *retired;
+    int retired_count;
+
+    /* Readers */
+    dll_rcu_reader_t readers[DLL_RCU_MAX_READERS];
+} dll_rcu_t;
+
+/* Function to get the node at a position in the pool */
+static inline dll_rcu_node_t *dll_rcu_node (dll_rcu_t *dll, int position)
+{
+    return (dll_rcu_node_t *)(dll->pool + ((size_t)position * dll->node_size));
+}
+
+/* Function to get the element stored in a node */
+static inline void *dll_rcu_payload (dll_rcu_node_t *node)
+{
+    return (void *)((unsigned char *)node + sizeof(dll_rcu_node_t));
+}
+
+/* Function to register a reader thread, returns its reader number or -1 if every slot is taken */
+static inline int dll_rcu_register (dll_rcu_t *dll)
+{
+    int reader = -1;
+
+    for (int i = 0; i < DLL_RCU_MAX_READERS; i++)
+    {
+        bool expected = false;
+        /* Claim the first free slot, another thread claiming it at the same time makes the CAS fail */
+        if (!atomic_load_explicit(&dll->readers[i].in_use, memory_order_relaxed) &&
+            atomic_compare_exchange_strong_explicit(&dll->readers[i].in_use, &expected, true,
+                                                    memory_order_acquire, memory_order_relaxed))
+        {
+            reader = i;
+            break;
+        }
+    }
+    return reader;
+}
+
+/* Function to give back the slot of a reader thread, outside any read section, the number must not be used after */
+static inline void dll_rcu_unregister (dll_rcu_t *dll, int reader)
+{
+    if ((reader >= 0) && (reader < DLL_RCU_MAX_READERS))
+    {
+        /* The sequence number is even outside a read section, so the next owner starts outside too */
+        atomic_store_explicit(&dll->readers[reader].in_use, false, memory_order_release);
+    }
+}
+
+/* Function to enter a read section, the nodes seen inside are not reused until it is left */
+static inline void dll_rcu_read_lock (dll_rcu_t *dll, int reader)
+{
+    atomic_ullong *seq = &dll->readers[reader].seq;
+
+    atomic_store_explicit(seq, atomic_load_explicit(seq, memory_order_relaxed) + 1u, memory_order_relaxed);
+    /* The writer must see the reader inside before the reader reads any link */
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+/* Function to leave a read section */
+static inline void dll_rcu_read_unlock (dll_rcu_t *dll, int reader)
+{
+    atomic_ullong *seq = &dll->readers[reader].seq;
+
+    /* Release keeps every read of the section before it */
+    atomic_store_explicit(seq, atomic_load_explicit(seq, memory_order_relaxed) + 1u, memory_order_release);
+}
+
+/* Function to traverse through the DLL buffer from a reader thread, from head to tail */
+static inline dll_rc_t dll_rcu_traverse (dll_rcu_t *dll, int reader, dll_visit_t visit)
+{
+    dll_rc_t rc = RC_DLLBUF_ERR_EMPTY;
+
+    dll_rcu_read_lock(dll, reader);
+    for (dll_rcu_node_t *node = atomic_load_explicit(&dll->head, memory_order_acquire); node != NULL;
+         node = atomic_load_explicit(&node->next, memory_order_acquire))
+    {
+        visit(node->idx, dll_rcu_payload(node));
+        rc = RC_DLLBUF_OK;
+    }
+    dll_rcu_read_unlock(dll, reader);
+    return rc;
+}
+
+/* Function to copy out the first element from the head with an index, from a reader thread */
+static inline dll_rc_t dll_rcu_find (dll_rcu_t *dll, int reader, int idx, void *element)
+{
+    dll_rc_t rc = RC_DLLBUF_NOT_FOUND;
+
+    dll_rcu_read_lock(dll, reader);
+    for (dll_rcu_node_t *node = atomic_load_explicit(&dll->head, memory_order_acquire); node != NULL;
+         node = atomic_load_explicit(&node->next, memory_order_acquire))
+    {
+        if (node->idx == idx)
+        {
+            (void) memcpy (element, dll_rcu_payload(node), dll->elem_size);
+            rc = RC_DLLBUF_OK;
+            break;
+        }
+    }
+    dll_rcu_read_unlock(dll, reader);
+    return rc;
+}
+
+/* Function to wait for a grace period, until every reader inside a read section has left it */
+static inline void dll_rcu_synchronize (dll_rcu_t *dll)
+{
+    /* Pairs with the fence of the readers, the unlinks are seen before the readers are checked */
+    atomic_thread_fence(memory_order_seq_cst);
+    for (int i = 0; i < DLL_RCU_MAX_READERS; i++)
+    {
+        /* A free slot is outside any read section */
+        if (!atomic_load_explicit(&dll->readers[i].in_use, memory_order_relaxed))
+        {
+            continue;
+        }
+        unsigned long long seq = atomic_load_explicit(&dll->readers[i].seq, memory_order_acquire);
+        /* An even number is outside, any change means the section seen has been left */
+        while (((seq & 1u) != 0u) && (atomic_load_explicit(&dll->readers[i].seq, memory_order_acquire) == seq))
+        {
+            sched_yield();
+        }
+    }
+}
+
+/* Function to put the retired nodes on the end of the free chain, after a grace period */
+static inline void dll_rcu_reclaim (dll_rcu_t *dll)
+{
+    if (dll->retired != NULL)
+    {
+        dll_rcu_synchronize(dll);
+        while (dll->retired != NULL)
+        {
+            dll_rcu_node_t *node = dll->retired;
+            dll->retired = node->prev;
+            /* No reader can reach the node any more */
+            node->prev = NULL;
+            atomic_store_explicit(&node->next, NULL, memory_order_relaxed);
+            if (dll->free == NULL)
+            {
+                dll->free = node;
+            }
+            else
+            {
+                atomic_store_explicit(&dll->end->next, node, memory_order_relaxed);
+            }
+            dll->end = node;
+        }
+        dll->retired_count = 0;
+    }
+}
+
+/* Funtion to add an element at the tail of the DLL buffer, from the writer thread */
+static inline dll_rc_t dll_rcu_add (dll_rcu_t *dll, int idx, const void *element)
+{
+    dll_rc_t rc = RC_DLLBUF_ERR_FULL;
+
+    /* Reclaim the retired nodes only when there is no free node left */
+    if (dll->free == NULL)
+    {
+        dll_rcu_reclaim(dll);
+    }
+    if (dll->free != NULL)
+    {
+        dll_rcu_node_t *node = dll->free;
+        dll->free = atomic_load_explicit(&node->next, memory_order_relaxed);
+
+        /* Write the node completely before it can be reached */
+        node->idx = idx;
+        (void) memcpy (dll_rcu_payload(node), element, dll->elem_size);
+        atomic_store_explicit(&node->next, NULL, memory_order_relaxed);
+        node->prev = dll->tail;
+
+        /* Publish it, release makes the writes above visible to whoever reads the link */
+        if (dll->tail != NULL)
+        {
+            atomic_store_explicit(&dll->tail->next, node, memory_order_release);
+        }
+        else
+        {
+            atomic_store_explicit(&dll->head, node, memory_order_release);
+        }
+        dll->tail = node;
+        dll->alloc_count++;
+        rc = RC_DLLBUF_OK;
+    }
+    return rc;
+}
+
+/* Function to remove an element from the DLL buffer, from the head in case of conventional remove or by index
+    Only from the writer thread. The node is retired, its element is copied out before.
+*/
+static inline dll_rc_t dll_rcu_remove (dll_rcu_t *dll, void *element, bool conv_remove, int idx)
+{
+    dll_rc_t rc = RC_DLLBUF_ERR_EMPTY;
+    dll_rcu_node_t *node = atomic_load_explicit(&dll->head, memory_order_relaxed);
+
+    if (node != NULL)
+    {
+        /* The writer is the only one changing links, so it reads them relaxed */
+        while ((!conv_remove) && (node != NULL) && (node->idx != idx))
+        {
+            node = atomic_load_explicit(&node->next, memory_order_relaxed);
+        }
+        rc = RC_DLLBUF_NOT_FOUND;
+    }
+
+    if (node != NULL)
+    {
+        dll_rcu_node_t *next = atomic_load_explicit(&node->next, memory_order_relaxed);
+
+        /* Unlink the node, readers on it keep its next link and walk on */
+        if (node->prev != NULL)
+        {
+            atomic_store_explicit(&node->prev->next, next, memory_order_release);
+        }
+        else
+        {
+            atomic_store_explicit(&dll->head, next, memory_order_release);
+        }
+        if (next != NULL)
+        {
+            next->prev = node->prev;
+        }
+        else
+        {
+            dll->tail = node->prev;
+        }
+        (void) memcpy (element, dll_rcu_payload(node), dll->elem_size);
+
+        /* Retire it, chained through prev which no reader uses */
+        node->prev = dll->retired;
+        dll->retired = node;
+        dll->retired_count++;
+        dll->alloc_count--;
+        rc = RC_DLLBUF_OK;
+    }
+    return rc;
+}
+
+/* Initialize the DLL buffer over a caller supplied pool of DLL_RCU_STORAGE_SIZE(length, elem_size) bytes */
+static inline void dll_rcu_init (dll_rcu_t *dll, void *storage, int length, size_t elem_size)
+{
+    /* Set the buffer size */
+    dll->length = length;
+    dll->elem_size = elem_size;
+    dll->node_size = DLL_RCU_NODE_SIZE(elem_size);
+    dll->pool = (unsigned char *)storage;
+    dll->alloc_count = 0;
+
+    /* The list is empty and every node is on the free chain */
+    atomic_init(&dll->head, NULL);
+    dll->tail = NULL;
+    dll->retired = NULL;
+    dll->retired_count = 0;
+    for (int i = 0; i < length; i++)
+    {
+        dll_rcu_node_t *node = dll_rcu_node(dll, i);
+        atomic_init(&node->next, ((i + 1) < length) ? dll_rcu_node(dll, i + 1) : NULL);
+        node->prev = NULL;
+    }
+    dll->free = (length > 0) ? dll_rcu_node(dll, 0) : NULL;
+    dll->end = (length > 0) ? dll_rcu_node(dll, length - 1) : NULL;
+
+    /* Every reader slot is free */
+    for (int i = 0; i < DLL_RCU_MAX_READERS; i++)
+    {
+        atomic_init(&dll->readers[i].seq, 0u);
+        atomic_init(&dll->readers[i].in_use, false);
+    }
+}
+
+/* De-Initialize the DLL buffer, once no reader uses it */
+static inline void dll_rcu_deInit (dll_rcu_t *dll)
+{
+    /* Set the buffer size */
+    dll->length = 0;
+    dll->alloc_count = 0;
+    dll->pool = NULL;
+    atomic_store(&dll->head, NULL);
+    dll->tail = dll->free = dll->end = dll->retired = NULL;
+    dll->retired_count = 0;
+}
+
+#endif /* DLL_RCU_H */
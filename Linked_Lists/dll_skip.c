@@ -0,0 +1,113 @@
+/* Demonstration of the ordered DLL buffer in dll_skip.h
+    Elements with scattered indices are added at the tail. They are then visited by a range of
+    indices, iterated in idx order, and removed both from the head as before and by index.
+*/
+
+/* Standard libarary includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* The counters of -DBUF_STATS and the trace of -DBUF_TRACE are defined in this file */
+#define BUF_STATS_IMPLEMENTATION
+#define BUF_TRACE_IMPLEMENTATION
+
+#include "dll_skip.h"
+
+/* Buffer size */
+#define BUFFER_LENGTH           100000
+
+/* Number of range queries timed, and the width of each range */
+#define QUERY_COUNT             100000
+#define RANGE_WIDTH             1000
+
+/* The data organized in structure */
+typedef struct
+{
+    int idx;
+    int data;
+} data_t;
+
+/* Static allocation of data is preferred */
+_Alignas(dll_node_t) unsigned char data[DLL_SKIP_STORAGE_SIZE(BUFFER_LENGTH, sizeof(data_t))];
+
+dll_skip_t dll_skip_ctrl;
+
+/* Number of elements visited and the last idx seen, to check the order */
+long long visit_count;
+int last_idx;
+int order_errors;
+
+void count_element (int idx, void *element)
+{
+    (void) element;
+    visit_count++;
+    if (idx < last_idx)
+    {
+        order_errors++;
+    }
+    last_idx = idx;
+}
+
+/* Function to print an element while traversing */
+void print_element (int idx, void *element)
+{
+    printf ("[Idx: %d, Data: %d] -> ", idx, ((data_t *)element)->data);
+}
+
+int main()
+{
+    printf("\nOrdered DLL Buffer Implementation. Length of buffer: %d\n", BUFFER_LENGTH);
+    struct timespec start, stop;
+    data_t element;
+
+    dll_skip_init(&dll_skip_ctrl, data, BUFFER_LENGTH, sizeof(data_t));
+    srand(1);
+    for (int i = 0; i < BUFFER_LENGTH; i++)
+    {
+        element.idx = rand() % (10 * BUFFER_LENGTH);
+        element.data = i;
+        (void) dll_skip_add(&dll_skip_ctrl, element.idx, &element);
+    }
+
+    /* Range queries */
+    visit_count = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < QUERY_COUNT; i++)
+    {
+        int low = rand() % (10 * BUFFER_LENGTH);
+        last_idx = low;
+        (void) dll_skip_range(&dll_skip_ctrl, low, low + RANGE_WIDTH - 1, count_element);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    double seconds = (stop.tv_sec - start.tv_sec) + ((stop.tv_nsec - start.tv_nsec) / 1e9);
+    printf("%d range queries of width %d: %.0f ns each, %.1f elements found on average, %d out of order\n",
+           QUERY_COUNT, RANGE_WIDTH, (seconds * 1e9) / QUERY_COUNT, (double)visit_count / QUERY_COUNT, order_errors);
+
+    /* Iterate the whole list in idx order */
+    int count = 0;
+    last_idx = -1;
+    for (dll_node_t *node = dll_skip_seek(&dll_skip_ctrl, 0); node != NULL; node = dll_skip_next(&dll_skip_ctrl, node))
+    {
+        count_element(node->idx, dll_payload(node));
+        count++;
+    }
+    printf("Iterated %d elements in idx order, %d out of order\n", count, order_errors);
+
+    /* Remove from the head, the oldest element, and by index */
+    (void) dll_skip_remove(&dll_skip_ctrl, &element, true, 0);
+    printf("\nConventional remove: idx %d, data %d (the first added)\n", element.idx, element.data);
+    dll_node_t *lowest = dll_skip_seek(&dll_skip_ctrl, 0);
+    int lowest_idx = lowest->idx;
+    (void) dll_skip_remove(&dll_skip_ctrl, &element, false, lowest_idx);
+    printf("Conditional remove of the lowest idx %d: data %d\n", element.idx, element.data);
+
+    printf("\nIndices from 0 to 100: ");
+    (void) dll_skip_range(&dll_skip_ctrl, 0, 100, print_element);
+    printf("End\n");
+
+    /* De-init the buffer */
+    dll_skip_deInit(&dll_skip_ctrl);
+    printf("\nExited program");
+    return 0;
+}
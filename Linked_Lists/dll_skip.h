@@ -0,0 +1,250 @@
+/* An ordered index on idx for the Doubly Linked List (DLL) buffer, a skip list over the same node pool
+    The list keeps its order of insertion, adds at the tail and conventional removes from the head,
+    as in dll.h. Every node in use is also in a skip list ordered by idx, so the elements can be looked
+    up, removed and iterated in idx order, and a range of idx visited, in O(log n).
+
+    Each node of the pool has a tower of forward links into the skip list at the same position in a
+    tower array that follows the pool. A tower is linked on the lowest levels only: every level above
+    the first is reached by a quarter of the towers of the level below it.
+
+    Level 2   HEAD ---------------------------> [ 9 ] ----------------------> NULL
+    Level 1   HEAD ------------> [ 4 ] -------> [ 9 ] ------------> [ 15 ] -> NULL
+    Level 0   HEAD -> [ 1 ] ---> [ 4 ] -> [ 7 ] [ 9 ] -> [ 12 ] --> [ 15 ] -> NULL
+
+    A search starts on the highest level and drops a level whenever the next tower is past the idx,
+    so it skips most of the towers. Elements with the same idx are kept in the order they were added,
+    and removing an element by idx removes the oldest one, as with dll_remove.
+*/
+#ifndef DLL_SKIP_H
+#define DLL_SKIP_H
+
+/* Standard libarary includes */
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* The list is a DLL buffer */
+#include "dll.h"
+
+/* Number of levels, enough for 4 ^ DLL_SKIP_MAX_LEVEL elements */
+#ifndef DLL_SKIP_MAX_LEVEL
+#define DLL_SKIP_MAX_LEVEL      12
+#endif
+
+/* Forward links of one node in the skip list */
+typedef struct dll_skip_tower_t
+{
+    int idx;
+    int level;
+    dll_node_t *node;
+    struct dll_skip_tower_t *forward[DLL_SKIP_MAX_LEVEL];
+} dll_skip_tower_t;
+
+/* Size of the node pool and towers the caller must supply for length elements */
+#define DLL_SKIP_STORAGE_SIZE(length, elem_size) \
+    (DLL_STORAGE_SIZE(length, elem_size) + ((size_t)(length) * sizeof(dll_skip_tower_t)))
+
+/* Ordered DLL buffer structure declaration */
+typedef struct
+{
+    dll_buf_t list;
+    dll_skip_tower_t *towers;
+    /* Sentinel before the first tower of every level */
+    dll_skip_tower_t head;
+    int level;
+    uint32_t random;
+} dll_skip_t;
+
+/* Function to get the tower of a node */
+static inline dll_skip_tower_t *dll_skip_tower (dll_skip_t *skip, dll_node_t *node)
+{
+    return &skip->towers[((unsigned char *)node - skip->list.pool) / skip->list.node_size];
+}
+
+/* Function to pick the level of a new tower, each level is reached by a quarter of the level below */
+static inline int dll_skip_random_level (dll_skip_t *skip)
+{
+    int level = 1;
+
+    /* xorshift32 */
+    skip->random ^= skip->random << 13;
+    skip->random ^= skip->random >> 17;
+    skip->random ^= skip->random << 5;
+    for (uint32_t bits = skip->random; ((bits & 3u) == 0u) && (level < DLL_SKIP_MAX_LEVEL); bits >>= 2)
+    {
+        level++;
+    }
+    return level;
+}
+
+/* Function to find the last tower before idx on every level, after the towers with the same idx if after_equal */
+static inline void dll_skip_search (dll_skip_t *skip, int idx, bool after_equal, dll_skip_tower_t *update[DLL_SKIP_MAX_LEVEL])
+{
+    dll_skip_tower_t *tower = &skip->head;
+
+    for (int level = skip->level - 1; level >= 0; level--)
+    {
+        while ((tower->forward[level] != NULL) &&
+               ((tower->forward[level]->idx < idx) || (after_equal && (tower->forward[level]->idx == idx))))
+        {
+            tower = tower->forward[level];
+        }
+        update[level] = tower;
+    }
+}
+
+/* Function to link the tower of a newly added node, after the towers with the same idx */
+static inline void dll_skip_insert (dll_skip_t *skip, dll_node_t *node)
+{
+    dll_skip_tower_t *update[DLL_SKIP_MAX_LEVEL];
+    dll_skip_tower_t *tower = dll_skip_tower(skip, node);
+
+    tower->idx = node->idx;
+    tower->node = node;
+    tower->level = dll_skip_random_level(skip);
+    dll_skip_search(skip, node->idx, true, update);
+    for (int level = skip->level; level < tower->level; level++)
+    {
+        /* New levels start at the sentinel */
+        update[level] = &skip->head;
+    }
+    if (tower->level > skip->level)
+    {
+        skip->level = tower->level;
+    }
+    for (int level = 0; level < tower->level; level++)
+    {
+        tower->forward[level] = update[level]->forward[level];
+        update[level]->forward[level] = tower;
+    }
+}
+
+/* Function to unlink the tower of a node that is removed */
+static inline void dll_skip_delete (dll_skip_t *skip, dll_node_t *node)
+{
+    dll_skip_tower_t *update[DLL_SKIP_MAX_LEVEL];
+    dll_skip_tower_t *tower = dll_skip_tower(skip, node);
+
+    dll_skip_search(skip, node->idx, false, update);
+    for (int level = 0; level < tower->level; level++)
+    {
+        /* Walk past the older towers with the same idx to the one before this tower */
+        dll_skip_tower_t *before = update[level];
+        while (before->forward[level] != tower)
+        {
+            before = before->forward[level];
+        }
+        before->forward[level] = tower->forward[level];
+    }
+    while ((skip->level > 1) && (skip->head.forward[skip->level - 1] == NULL))
+    {
+        skip->level--;
+    }
+}
+
+/* Funtion to add an element at the tail of the ordered DLL buffer */
+static inline dll_rc_t dll_skip_add (dll_skip_t *skip, int idx, const void *element)
+{
+    dll_rc_t rc = RC_DLLBUF_ERR_FULL;
+    dll_node_t *node = dll_add_node(&skip->list, idx);
+
+    if (node != NULL)
+    {
+        (void) memcpy (dll_payload(node), element, skip->list.elem_size);
+        dll_skip_insert(skip, node);
+        rc = RC_DLLBUF_OK;
+    }
+    return rc;
+}
+
+/* Function to remove an element from the ordered DLL buffer, from the head in case of conventional remove or by index */
+static inline dll_rc_t dll_skip_remove (dll_skip_t *skip, void *element, bool conv_remove, int idx)
+{
+    /* Check if the buffer is empty */
+    dll_rc_t rc = dll_is_bufEmpty(&skip->list);
+
+    if (rc == RC_DLLBUF_OK)
+    {
+        dll_node_t *node = conv_remove ? skip->list.head : dll_find_node(&skip->list, idx);
+
+        if (node != NULL)
+        {
+            dll_skip_delete(skip, node);
+            (void) memcpy (element, dll_payload(node), skip->list.elem_size);
+            dll_unlink_node(&skip->list, node);
+        }
+        else
+        {
+            rc = RC_DLLBUF_NOT_FOUND;
+        }
+    }
+    return rc;
+}
+
+/* Function to find the first node in idx order with an idx of at least idx, returns NULL if there is none */
+static inline dll_node_t *dll_skip_seek (dll_skip_t *skip, int idx)
+{
+    dll_skip_tower_t *update[DLL_SKIP_MAX_LEVEL];
+    dll_skip_tower_t *tower;
+
+    dll_skip_search(skip, idx, false, update);
+    tower = update[0]->forward[0];
+    return (tower != NULL) ? tower->node : NULL;
+}
+
+/* Function to get the node after a node in idx order, returns NULL after the last one */
+static inline dll_node_t *dll_skip_next (dll_skip_t *skip, dll_node_t *node)
+{
+    dll_skip_tower_t *tower = dll_skip_tower(skip, node)->forward[0];
+
+    return (tower != NULL) ? tower->node : NULL;
+}
+
+/* Function to visit the elements with an idx from low to high, both included, in idx order */
+static inline dll_rc_t dll_skip_range (dll_skip_t *skip, int low, int high, dll_visit_t visit)
+{
+    dll_rc_t rc = RC_DLLBUF_NOT_FOUND;
+    dll_skip_tower_t *update[DLL_SKIP_MAX_LEVEL];
+
+    dll_skip_search(skip, low, false, update);
+    /* The towers of the range follow each other on the lowest level */
+    for (dll_skip_tower_t *tower = update[0]->forward[0]; (tower != NULL) && (tower->idx <= high); tower = tower->forward[0])
+    {
+        visit(tower->idx, dll_payload(tower->node));
+        rc = RC_DLLBUF_OK;
+    }
+    return rc;
+}
+
+/* Initialize the ordered DLL buffer over a caller supplied pool of DLL_SKIP_STORAGE_SIZE(length, elem_size) bytes */
+static inline void dll_skip_init (dll_skip_t *skip, void *storage, int length, size_t elem_size)
+{
+    dll_init(&skip->list, storage, length, elem_size);
+    /* The towers follow the node pool and its index */
+    skip->towers = (dll_skip_tower_t *)((unsigned char *)storage + DLL_STORAGE_SIZE(length, elem_size));
+    skip->level = 1;
+    skip->random = 0x2545F491u;
+    skip->head.idx = 0;
+    skip->head.level = DLL_SKIP_MAX_LEVEL;
+    skip->head.node = NULL;
+    for (int level = 0; level < DLL_SKIP_MAX_LEVEL; level++)
+    {
+        skip->head.forward[level] = NULL;
+    }
+}
+
+/* De-Initialize the ordered DLL buffer */
+static inline void dll_skip_deInit (dll_skip_t *skip)
+{
+    dll_deInit(&skip->list);
+    skip->towers = NULL;
+    skip->level = 1;
+    for (int level = 0; level < DLL_SKIP_MAX_LEVEL; level++)
+    {
+        skip->head.forward[level] = NULL;
+    }
+}
+
+#endif /* DLL_SKIP_H */
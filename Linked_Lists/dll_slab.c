@@ -0,0 +1,113 @@
+/* Demonstration of the slab mode of the DLL buffer in dll.h
+    The static pool holds BUFFER_LENGTH elements. A burst adds many more, the buffer grows by slabs
+    instead of returning RC_DLLBUF_ERR_FULL, and the node of the first element keeps its address.
+    When most elements are removed again, dll_slab_trim returns the slabs left without an element,
+    keeping FREE_WATERMARK free nodes for the next burst.
+*/
+
+/* Standard libarary includes */
+#include <stdio.h>
+
+/* The counters of -DBUF_STATS and the trace of -DBUF_TRACE are defined in this file */
+#define BUF_STATS_IMPLEMENTATION
+#define BUF_TRACE_IMPLEMENTATION
+
+#include "dll.h"
+
+/* Buffer size of the static pool */
+#define BUFFER_LENGTH           64
+
+/* Nodes in each slab, and the free nodes kept when trimming */
+#define SLAB_LENGTH             256
+#define FREE_WATERMARK          512
+
+/* Elements added by the burst, and kept after it */
+#define BURST_LENGTH            100000
+#define KEEP_LENGTH             100
+
+/* The data organized in structure */
+typedef struct
+{
+    int idx;
+    int data;
+} data_t;
+
+/* Static allocation of data is preferred */
+_Alignas(dll_node_t) unsigned char data[DLL_STORAGE_SIZE(BUFFER_LENGTH, sizeof(data_t))];
+
+dll_buf_t dll_buf_ctrl;
+
+/* Function to count the slabs of the buffer */
+int slab_count (dll_buf_t *dll)
+{
+    int count = 0;
+    for (dll_slab_t *slab = dll->slabs; slab != NULL; slab = slab->next)
+    {
+        count++;
+    }
+    return count;
+}
+
+/* Function to print the size of the buffer */
+void print_size (const char *when)
+{
+    printf("%-18s %6d elements, %6d nodes, %4d slabs, index of %6d slots\n", when, dll_buf_ctrl.alloc_count,
+           dll_buf_ctrl.length, slab_count(&dll_buf_ctrl), dll_buf_ctrl.index_length);
+}
+
+int main()
+{
+    printf("\nDLL Buffer with slabs. Length of static pool: %d, slab length: %d, free watermark: %d\n",
+           BUFFER_LENGTH, SLAB_LENGTH, FREE_WATERMARK);
+    data_t element;
+    dll_node_t *first;
+    int errors = 0;
+
+    dll_init(&dll_buf_ctrl, data, BUFFER_LENGTH, sizeof(data_t));
+    dll_enable_slabs(&dll_buf_ctrl, SLAB_LENGTH, FREE_WATERMARK);
+    print_size("Initialized:");
+
+    /* A burst far larger than the static pool */
+    for (int i = 0; i < BURST_LENGTH; i++)
+    {
+        element.idx = i;
+        element.data = 3 * i;
+        if (dll_add(&dll_buf_ctrl, i, &element) != RC_DLLBUF_OK)
+        {
+            errors++;
+        }
+    }
+    first = dll_buf_ctrl.head;
+    print_size("After the burst:");
+
+    /* Remove most elements, from the middle so the oldest one stays at the head */
+    for (int i = 1; i < (BURST_LENGTH - KEEP_LENGTH + 1); i++)
+    {
+        if ((dll_remove(&dll_buf_ctrl, &element, false, i) != RC_DLLBUF_OK) || (element.data != (3 * i)))
+        {
+            errors++;
+        }
+    }
+    print_size("After the removes:");
+
+    printf("Slabs returned: %d\n", dll_slab_trim(&dll_buf_ctrl));
+    print_size("After the trim:");
+
+    /* The elements left must be intact, and the head node must not have moved */
+    if (dll_buf_ctrl.head != first)
+    {
+        errors++;
+    }
+    for (int i = BURST_LENGTH - KEEP_LENGTH + 1; i < BURST_LENGTH; i++)
+    {
+        if ((dll_find(&dll_buf_ctrl, i, &element) != RC_DLLBUF_OK) || (element.data != (3 * i)))
+        {
+            errors++;
+        }
+    }
+    printf("%d errors\n", errors);
+
+    dll_deInit(&dll_buf_ctrl);
+    printf("\nExited program");
+    return 0;
+}
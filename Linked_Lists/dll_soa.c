@@ -0,0 +1,122 @@
+/* Demonstration of the compact DLL buffer in dll_soa.h
+    The same list is built in the DLL buffer of dll.h and in the compact one, then both are walked
+    from head to tail, by traversal and by a conditional remove of an index that is not in the list.
+    The compact pool is then copied to another address and used from there.
+*/
+
+/* Standard libarary includes */
+#include <stdio.h>
+#include <time.h>
+
+/* The counters of -DBUF_STATS and the trace of -DBUF_TRACE are defined in this file */
+#define BUF_STATS_IMPLEMENTATION
+#define BUF_TRACE_IMPLEMENTATION
+
+#include "dll_soa.h"
+
+/* Buffer size */
+#define BUFFER_LENGTH           200000
+
+/* Number of walks through the whole list */
+#define WALK_COUNT              50
+
+/* The data organized in structure */
+typedef struct
+{
+    int idx;
+    int data;
+} data_t;
+
+/* Static allocation of data is preferred */
+_Alignas(dll_node_t) unsigned char data[DLL_STORAGE_SIZE(BUFFER_LENGTH, sizeof(data_t))];
+_Alignas(max_align_t) unsigned char soa_data[DLL_SOA_STORAGE_SIZE(BUFFER_LENGTH, sizeof(data_t))];
+_Alignas(max_align_t) unsigned char soa_copy[DLL_SOA_STORAGE_SIZE(BUFFER_LENGTH, sizeof(data_t))];
+
+dll_buf_t dll_buf_ctrl;
+dll_soa_t dll_soa_ctrl;
+
+/* Sum of the data of the visited elements */
+long long visit_sum;
+
+void sum_element (int idx, void *element)
+{
+    (void) idx;
+    visit_sum += ((data_t *)element)->data;
+}
+
+/* Function to get the time since start in seconds */
+double seconds_since (struct timespec *start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + ((now.tv_nsec - start->tv_nsec) / 1e9);
+}
+
+int main()
+{
+    printf("\nCompact DLL Buffer Implementation. Length of buffer: %d, %d-bit links\n", BUFFER_LENGTH, DLL_SOA_LINK_BITS);
+    struct timespec start;
+    data_t element;
+    long long expected = 0;
+
+    dll_init(&dll_buf_ctrl, data, BUFFER_LENGTH, sizeof(data_t));
+    if (dll_soa_init(&dll_soa_ctrl, soa_data, BUFFER_LENGTH, sizeof(data_t)) != RC_DLLBUF_OK)
+    {
+        printf("\nError - buffer length does not fit in the links.\n");
+        return 1;
+    }
+    for (int i = 0; i < BUFFER_LENGTH; i++)
+    {
+        element.idx = i;
+        element.data = i % 1000;
+        expected += element.data;
+        (void) dll_add(&dll_buf_ctrl, element.idx, &element);
+        (void) dll_soa_add(&dll_soa_ctrl, element.idx, &element);
+    }
+    printf("Bytes read per node by a walk: %zu with pointers, %zu compact\n", sizeof(dll_node_t),
+           sizeof(int32_t) + sizeof(dll_soa_link_t));
+
+    /* Traverse both lists */
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < WALK_COUNT; i++)
+    {
+        visit_sum = 0;
+        (void) dll_traverse(&dll_buf_ctrl, sum_element);
+    }
+    double seconds = seconds_since(&start);
+    printf("Traverse, pointer nodes:  %.2f ns per node, %s\n", (seconds * 1e9) / ((double)WALK_COUNT * BUFFER_LENGTH),
+           (visit_sum == expected) ? "sum correct" : "WRONG SUM");
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < WALK_COUNT; i++)
+    {
+        visit_sum = 0;
+        (void) dll_soa_traverse(&dll_soa_ctrl, sum_element);
+    }
+    seconds = seconds_since(&start);
+    printf("Traverse, compact nodes:  %.2f ns per node, %s\n", (seconds * 1e9) / ((double)WALK_COUNT * BUFFER_LENGTH),
+           (visit_sum == expected) ? "sum correct" : "WRONG SUM");
+
+    /* A remove of a missing index walks the whole compact list */
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < WALK_COUNT; i++)
+    {
+        (void) dll_soa_remove(&dll_soa_ctrl, &element, false, -1);
+    }
+    seconds = seconds_since(&start);
+    printf("Search, compact nodes:    %.2f ns per node\n", (seconds * 1e9) / ((double)WALK_COUNT * BUFFER_LENGTH));
+
+    /* Move the compact pool and use it from the new address */
+    (void) memcpy (soa_copy, soa_data, sizeof(soa_data));
+    dll_soa_relocate(&dll_soa_ctrl, soa_copy);
+    dll_rc_t rc = dll_soa_remove(&dll_soa_ctrl, &element, false, BUFFER_LENGTH / 2);
+    printf("\nAfter relocating the pool, removed idx %d: %s\n", BUFFER_LENGTH / 2,
+           ((rc == RC_DLLBUF_OK) && (element.idx == (BUFFER_LENGTH / 2))) ? "found" : "ERROR");
+
+    /* De-init the buffers */
+    dll_deInit(&dll_buf_ctrl);
+    dll_soa_deInit(&dll_soa_ctrl);
+    printf("\nExited program");
+    return 0;
+}
@@ -0,0 +1,290 @@
+/* A compact Doubly Linked List (DLL) buffer with index links and a structure of arrays node pool
+    An element can be added only at the tail, but can be removed from anywhere, as in dll.h.
+
+    Instead of one array of nodes each carrying two pointers next to the element, the pool is split
+    into separate arrays, and the links are indices into them rather than addresses:
+
+     _______________________________
+    |_IDX_|_IDX_|_IDX_|_IDX_|_IDX_|...     int32_t idx[length]
+    |NEXT_|NEXT_|NEXT_|NEXT_|NEXT_|...     dll_soa_link_t next[length]
+    |PREV_|PREV_|PREV_|PREV_|PREV_|...     dll_soa_link_t prev[length]
+    |__ELEMENT__|__ELEMENT__|_____|...     elem_size bytes each
+
+    Links are 32-bit, or 16-bit when DLL_SOA_LINK_BITS is defined as 16 before the include, for pools
+    of fewer than 65535 nodes. Walking the list reads only the next and idx arrays, 8 (or 6) bytes per
+    node instead of a whole node with two 64-bit pointers, so at least twice as many nodes share a
+    cache line, and the walk prefetches the node after the next one while it visits the current one.
+
+    The pool holds no address, so it can be copied, mapped or shared at any address. After moving it,
+    dll_soa_relocate points the buffer at the new place.
+
+    The conditional remove walks the list from the head like the original DLL did. Use the index of
+    dll.h when lists are long and removes by index are frequent, this layout when walks dominate.
+*/
+#ifndef DLL_SOA_H
+#define DLL_SOA_H
+
+/* Standard libarary includes */
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* The return codes and the visit function are shared with the basic DLL buffer */
+#include "dll.h"
+
+/* Width of a link */
+#ifndef DLL_SOA_LINK_BITS
+#define DLL_SOA_LINK_BITS       32
+#endif
+
+#if (DLL_SOA_LINK_BITS == 16)
+typedef uint16_t dll_soa_link_t;
+#define DLL_SOA_NIL             UINT16_MAX
+#else
+typedef uint32_t dll_soa_link_t;
+#define DLL_SOA_NIL             UINT32_MAX
+#endif
+
+/* Function to round a size up to the alignment of any element */
+#define DLL_SOA_ALIGN(size)     (((size) + (_Alignof(max_align_t) - 1u)) & ~(_Alignof(max_align_t) - 1u))
+
+/* Sizes of the arrays of the pool */
+#define DLL_SOA_IDX_SIZE(length)        DLL_SOA_ALIGN((size_t)(length) * sizeof(int32_t))
+#define DLL_SOA_LINK_SIZE(length)       DLL_SOA_ALIGN((size_t)(length) * sizeof(dll_soa_link_t))
+
+/* Size of the pool the caller must supply for length elements, aligned to max_align_t */
+#define DLL_SOA_STORAGE_SIZE(length, elem_size) \
+    (DLL_SOA_IDX_SIZE(length) + (2u * DLL_SOA_LINK_SIZE(length)) + ((size_t)(length) * (elem_size)))
+
+/* Compact DLL buffer structure declaration, every position in it is an index into the pool */
+typedef struct
+{
+    int length;
+    int alloc_count;
+    size_t elem_size;
+    dll_soa_link_t head;
+    dll_soa_link_t tail;
+    dll_soa_link_t free;
+    /* The arrays of the pool, set from the storage address by dll_soa_relocate */
+    int32_t *idx;
+    dll_soa_link_t *next;
+    dll_soa_link_t *prev;
+    unsigned char *payload;
+} dll_soa_t;
+
+/* Function to get the element stored at a position */
+static inline void *dll_soa_payload (dll_soa_t *dll, dll_soa_link_t position)
+{
+    return (void *)(dll->payload + ((size_t)position * dll->elem_size));
+}
+
+/* Function to prefetch the links, index and element of a position ahead of the walk */
+static inline void dll_soa_prefetch (dll_soa_t *dll, dll_soa_link_t position)
+{
+#if defined(__GNUC__)
+    if (position != DLL_SOA_NIL)
+    {
+        __builtin_prefetch(&dll->next[position]);
+        __builtin_prefetch(&dll->idx[position]);
+        __builtin_prefetch(dll_soa_payload(dll, position));
+    }
+#else
+    (void) dll;
+    (void) position;
+#endif
+}
+
+/* Function to check if the compact DLL buffer is empty */
+static inline dll_rc_t dll_soa_is_bufEmpty (dll_soa_t *dll)
+{
+    dll_rc_t rc = RC_DLLBUF_OK;
+
+    if (dll->alloc_count == 0)
+    {
+        rc = RC_DLLBUF_ERR_EMPTY;
+    }
+    return rc;
+}
+
+/* Function to check if the compact DLL buffer is full */
+static inline dll_rc_t dll_soa_is_bufFull (dll_soa_t *dll)
+{
+    dll_rc_t rc = RC_DLLBUF_OK;
+
+    if (dll->free == DLL_SOA_NIL)
+    {
+        rc = RC_DLLBUF_ERR_FULL;
+    }
+    return rc;
+}
+
+/* Funtion to add an element at the tail of the compact DLL buffer */
+static inline dll_rc_t dll_soa_add (dll_soa_t *dll, int idx, const void *element)
+{
+    /* Check if the buffer is full */
+    dll_rc_t rc = dll_soa_is_bufFull(dll);
+
+    if (rc == RC_DLLBUF_OK)
+    {
+        /* Take the first free position */
+        dll_soa_link_t position = dll->free;
+        dll->free = dll->next[position];
+
+        /* Link it after the tail */
+        dll->idx[position] = idx;
+        dll->next[position] = DLL_SOA_NIL;
+        dll->prev[position] = dll->tail;
+        if (dll->tail != DLL_SOA_NIL)
+        {
+            dll->next[dll->tail] = position;
+        }
+        else
+        {
+            dll->head = position;
+        }
+        dll->tail = position;
+        (void) memcpy (dll_soa_payload(dll, position), element, dll->elem_size);
+        dll->alloc_count++;
+    }
+    return rc;
+}
+
+/* Function to find the first position from the head with an index, returns DLL_SOA_NIL if there is none */
+static inline dll_soa_link_t dll_soa_find_position (dll_soa_t *dll, int idx)
+{
+    dll_soa_link_t position = dll->head;
+
+    while ((position != DLL_SOA_NIL) && (dll->idx[position] != idx))
+    {
+        position = dll->next[position];
+        /* Only the next and idx arrays are read, fetch the node after this one meanwhile */
+        if (position != DLL_SOA_NIL)
+        {
+            dll_soa_prefetch(dll, dll->next[position]);
+        }
+    }
+    return position;
+}
+
+/* Function to remove an element from the compact DLL buffer, from the head in case of conventional remove or by index */
+static inline dll_rc_t dll_soa_remove (dll_soa_t *dll, void *element, bool conv_remove, int idx)
+{
+    /* Check if the buffer is empty */
+    dll_rc_t rc = dll_soa_is_bufEmpty(dll);
+
+    if (rc == RC_DLLBUF_OK)
+    {
+        dll_soa_link_t position = conv_remove ? dll->head : dll_soa_find_position(dll, idx);
+
+        if (position == DLL_SOA_NIL)
+        {
+            rc = RC_DLLBUF_NOT_FOUND;
+        }
+        else
+        {
+            dll_soa_link_t next = dll->next[position], prev = dll->prev[position];
+
+            /* Unlink the position from its neighbours, or move the head or tail past it */
+            if (prev != DLL_SOA_NIL)
+            {
+                dll->next[prev] = next;
+            }
+            else
+            {
+                dll->head = next;
+            }
+            if (next != DLL_SOA_NIL)
+            {
+                dll->prev[next] = prev;
+            }
+            else
+            {
+                dll->tail = prev;
+            }
+            (void) memcpy (element, dll_soa_payload(dll, position), dll->elem_size);
+
+            /* Put the position on the free chain */
+            dll->next[position] = dll->free;
+            dll->free = position;
+            dll->alloc_count--;
+        }
+    }
+    return rc;
+}
+
+/* Function to traverse through the compact DLL buffer, from head to tail */
+static inline dll_rc_t dll_soa_traverse (dll_soa_t *dll, dll_visit_t visit)
+{
+    /* Check if the buffer is empty */
+    dll_rc_t rc = dll_soa_is_bufEmpty(dll);
+
+    if (rc == RC_DLLBUF_OK)
+    {
+        for (dll_soa_link_t position = dll->head; position != DLL_SOA_NIL; position = dll->next[position])
+        {
+            /* Fetch the node after the next one while this one is visited */
+            dll_soa_link_t next = dll->next[position];
+            if (next != DLL_SOA_NIL)
+            {
+                dll_soa_prefetch(dll, dll->next[next]);
+            }
+            visit(dll->idx[position], dll_soa_payload(dll, position));
+        }
+    }
+    return rc;
+}
+
+/* Point the compact DLL buffer at its pool, after the pool was copied or mapped at another address */
+static inline void dll_soa_relocate (dll_soa_t *dll, void *storage)
+{
+    unsigned char *base = (unsigned char *)storage;
+
+    dll->idx = (int32_t *)base;
+    dll->next = (dll_soa_link_t *)(base + DLL_SOA_IDX_SIZE(dll->length));
+    dll->prev = (dll_soa_link_t *)(base + DLL_SOA_IDX_SIZE(dll->length) + DLL_SOA_LINK_SIZE(dll->length));
+    dll->payload = base + DLL_SOA_IDX_SIZE(dll->length) + (2u * DLL_SOA_LINK_SIZE(dll->length));
+}
+
+/* Initialize the compact DLL buffer over a caller supplied pool of DLL_SOA_STORAGE_SIZE(length, elem_size) bytes
+    Returns RC_DLLBUF_ERR_LENGTH if the positions do not fit in the links.
+*/
+static inline dll_rc_t dll_soa_init (dll_soa_t *dll, void *storage, int length, size_t elem_size)
+{
+    dll_rc_t rc = RC_DLLBUF_ERR_LENGTH;
+
+    if ((length > 0) && ((uint64_t)length < DLL_SOA_NIL))
+    {
+        /* Set the buffer size */
+        dll->length = length;
+        dll->elem_size = elem_size;
+        dll->alloc_count = 0;
+        dll_soa_relocate(dll, storage);
+
+        /* The list is empty and every position is on the free chain */
+        dll->head = dll->tail = DLL_SOA_NIL;
+        dll->free = 0;
+        for (int i = 0; i < length; i++)
+        {
+            dll->next[i] = ((i + 1) < length) ? (dll_soa_link_t)(i + 1) : DLL_SOA_NIL;
+            dll->prev[i] = DLL_SOA_NIL;
+        }
+        rc = RC_DLLBUF_OK;
+    }
+    return rc;
+}
+
+/* De-Initialize the compact DLL buffer */
+static inline void dll_soa_deInit (dll_soa_t *dll)
+{
+    /* Set the buffer size */
+    dll->length = 0;
+    dll->alloc_count = 0;
+    dll->head = dll->tail = dll->free = DLL_SOA_NIL;
+    dll->idx = NULL;
+    dll->next = dll->prev = NULL;
+    dll->payload = NULL;
+}
+
+#endif /* DLL_SOA_H */
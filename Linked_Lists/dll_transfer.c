@@ -0,0 +1,402 @@
+/* Demonstration of moving runs of nodes with dll_splice, dll_transfer and dll_split in dll.h
+    A run of a list is moved inside the list, to the tail of a second list and split off into a list
+    of its own, without copying an element. The moves are then made at random on two lists, together
+    with adds, removes and purges, and every list is compared with a model held in plain arrays after
+    each step: the elements in order, the index and the free chain after the tail.
+*/
+
+/* Standard libarary includes */
+#include <stdio.h>
+#include <stdlib.h>
+
+/* The counters of -DBUF_STATS and the trace of -DBUF_TRACE are defined in this file */
+#define BUF_STATS_IMPLEMENTATION
+#define BUF_TRACE_IMPLEMENTATION
+
+#include "dll.h"
+
+/* Buffer size */
+#define BUFFER_LENGTH           8
+
+/* Random steps made on the lists, and the steps after which they start again empty */
+#define STEP_COUNT              2000000
+#define RESTART_PERIOD          1000
+
+/* The data organized in structure */
+typedef struct
+{
+    int idx;
+    int data;
+} data_t;
+
+/* Static allocation of data is preferred */
+_Alignas(dll_node_t) unsigned char data_a[DLL_STORAGE_SIZE(BUFFER_LENGTH, sizeof(data_t))];
+_Alignas(dll_node_t) unsigned char data_b[DLL_STORAGE_SIZE(BUFFER_LENGTH, sizeof(data_t))];
+_Alignas(dll_index_slot_t) unsigned char index_c[DLL_SPLIT_STORAGE_SIZE(BUFFER_LENGTH)];
+
+dll_buf_t dll_buf_a, dll_buf_b, dll_buf_c;
+
+/* The model of one list, its elements from head to tail */
+typedef struct
+{
+    int count;
+    data_t element[2 * BUFFER_LENGTH];
+} model_t;
+
+model_t model_a, model_b, model_c;
+
+/* DLL functions specialized for data_t: data_dll_add, data_dll_remove, data_dll_find */
+DLL_BUF_DEFINE(data_dll, data_t)
+
+/* Function to print an element while traversing */
+void print_element (int idx, void *element)
+{
+    printf ("[Idx: %d, Data: %d] -> ", idx, ((data_t *)element)->data);
+}
+
+/* Function to print a list */
+void print_list (const char *name, dll_buf_t *dll)
+{
+    printf("%s: ", name);
+    (void) dll_traverse(dll, print_element);
+    printf("End\n");
+}
+
+/* Elements with data below this value are removed by the purge */
+int purge_below;
+
+/* Function to select the elements removed by the purge */
+bool is_below (int idx, const void *element)
+{
+    (void) idx;
+    return ((const data_t *)element)->data < purge_below;
+}
+
+/* Function to get the node at a position of a list, from the head */
+dll_node_t *node_at (dll_buf_t *dll, int position)
+{
+    dll_node_t *node = dll->head;
+
+    for (int i = 0; i < position; i++)
+    {
+        node = node->next;
+    }
+    return node;
+}
+
+/* Function to move count elements of a model from position to another model at position to */
+void model_move (model_t *from, int position, int count, model_t *to, int to_position)
+{
+    data_t run[2 * BUFFER_LENGTH];
+
+    for (int i = 0; i < count; i++)
+    {
+        run[i] = from->element[position + i];
+    }
+    for (int i = position; i < (from->count - count); i++)
+    {
+        from->element[i] = from->element[i + count];
+    }
+    from->count -= count;
+    for (int i = to->count - 1; i >= to_position; i--)
+    {
+        to->element[i + count] = to->element[i];
+    }
+    for (int i = 0; i < count; i++)
+    {
+        to->element[to_position + i] = run[i];
+    }
+    to->count += count;
+}
+
+/* Function to take the element the list finds for an idx out of a model, returns false if there is none */
+bool model_remove (model_t *model, int idx, data_t *element, dll_buf_t *dll)
+{
+    dll_node_t *node = dll_find_node(dll, idx);
+    bool found = false;
+
+    for (int i = 0; (i < model->count) && !found && (node != NULL); i++)
+    {
+        if ((model->element[i].idx == idx) && (model->element[i].data == ((data_t *)dll_payload(node))->data))
+        {
+            *element = model->element[i];
+            model_move(model, i, 1, &(model_t){ .count = 0 }, 0);
+            found = true;
+        }
+    }
+    return found;
+}
+
+/* Function to check that a model holds an element, the index orders elements with one idx as they entered the list */
+bool model_holds (model_t *model, const data_t *element)
+{
+    bool found = false;
+
+    for (int i = 0; (i < model->count) && !found; i++)
+    {
+        found = (model->element[i].idx == element->idx) && (model->element[i].data == element->data);
+    }
+    return found;
+}
+
+/* Function to compare a list with its model, returns the number of mismatches */
+int check (dll_buf_t *dll, model_t *model)
+{
+    int errors = (dll->alloc_count != model->count) ? 1 : 0;
+    dll_node_t *node = dll->head;
+    data_t element;
+
+    /* The elements in order, linked both ways, and each found through the index */
+    for (int i = 0; (i < model->count) && (errors == 0); i++)
+    {
+        data_t *payload = (data_t *)dll_payload(node);
+        if ((node->idx != model->element[i].idx) || (payload->data != model->element[i].data) ||
+            ((i == 0) ? (node->prev != NULL) : (node->prev->next != node)))
+        {
+            errors++;
+        }
+        else if ((data_dll_find(dll, node->idx, &element) != RC_DLLBUF_OK) ||
+                 !model_holds(model, &element))
+        {
+            errors++;
+        }
+        if (i == (model->count - 1))
+        {
+            errors += (node != dll->tail) ? 1 : 0;
+        }
+        node = node->next;
+    }
+
+    /* The free chain follows the tail, or starts at it when empty, and ends at the end */
+    if (errors == 0)
+    {
+        int free_count = 0;
+        dll_node_t *last = (model->count == 0) ? NULL : dll->tail;
+        for (node = (model->count == 0) ? dll->tail : dll->tail->next; node != NULL; node = node->next)
+        {
+            free_count++;
+            last = node;
+        }
+        errors += (free_count != (dll->length - dll->alloc_count)) ? 1 : 0;
+        errors += (last != dll->end) ? 1 : 0;
+    }
+    return errors;
+}
+
+/* Function to make one random step on the lists, returns the number of mismatches after it */
+int random_step (int step)
+{
+    dll_buf_t *dll[2] = { &dll_buf_a, &dll_buf_b };
+    model_t *model[2] = { &model_a, &model_b };
+    int side = rand() % 2;
+    dll_buf_t *list = dll[side];
+    model_t *mine = model[side];
+    data_t element, expected;
+    dll_rc_t rc;
+
+    switch (rand() % 8)
+    {
+        case 0:
+        case 1:
+        {
+            /* Add, a few idx values so that some are shared */
+            bool room = (mine->count < list->length);
+            element.idx = rand() % 8;
+            element.data = step;
+            rc = data_dll_add(list, element.idx, &element);
+            if ((rc == RC_DLLBUF_OK) != room)
+            {
+                return 1;
+            }
+            if (room)
+            {
+                mine->element[mine->count++] = element;
+            }
+        }
+        break;
+        case 2:
+        {
+            /* Remove from the head or by idx */
+            bool conv_remove = ((rand() % 2) == 0);
+            int idx = rand() % 8;
+            /* The model follows the list on which element of an idx goes first */
+            bool found = conv_remove ? (mine->count > 0) : model_remove(mine, idx, &expected, list);
+            if (conv_remove && found)
+            {
+                expected = mine->element[0];
+                model_move(mine, 0, 1, &(model_t){ .count = 0 }, 0);
+            }
+            rc = data_dll_remove(list, &element, conv_remove, idx);
+            if ((rc == RC_DLLBUF_OK) != found)
+            {
+                return 1;
+            }
+            if (found && (element.data != expected.data))
+            {
+                return 1;
+            }
+        }
+        break;
+        case 3:
+        {
+            /* Purge the older elements */
+            purge_below = step - (rand() % 64);
+            int removed = dll_remove_if(list, is_below, NULL);
+            for (int i = 0; i < mine->count; )
+            {
+                if (mine->element[i].data < purge_below)
+                {
+                    model_move(mine, i, 1, &(model_t){ .count = 0 }, 0);
+                    removed--;
+                }
+                else
+                {
+                    i++;
+                }
+            }
+            if (removed != 0)
+            {
+                return 1;
+            }
+        }
+        break;
+        case 4:
+        case 5:
+        {
+            /* Splice a run after another node outside it, or to the head */
+            if (mine->count > 0)
+            {
+                int first = rand() % mine->count;
+                int last = first + (rand() % (mine->count - first));
+                int after = rand() % (mine->count + 1);
+                if ((after == 0) || (after <= first) || (after > (last + 1)))
+                {
+                    /* after is 0 for the head, else the position after the node the run goes behind */
+                    dll_splice(list, node_at(list, first), node_at(list, last), (after == 0) ? NULL : node_at(list, after - 1));
+                    int count = last - first + 1;
+                    int to = (after > last) ? (after - count) : after;
+                    model_t run = { .count = 0 };
+                    model_move(mine, first, count, &run, 0);
+                    model_move(&run, 0, count, mine, to);
+                }
+            }
+        }
+        break;
+        case 6:
+        {
+            /* Transfer a run to the tail of the other list */
+            model_t *other = model[1 - side];
+            if (mine->count > 0)
+            {
+                int first = rand() % mine->count;
+                int last = first + (rand() % (mine->count - first));
+                int count = last - first + 1;
+                int room = dll[1 - side]->length - other->count;
+                rc = dll_transfer(dll[1 - side], list, node_at(list, first), node_at(list, last));
+                if ((rc == RC_DLLBUF_OK) != (room >= count))
+                {
+                    return 1;
+                }
+                if (rc == RC_DLLBUF_OK)
+                {
+                    model_move(mine, first, count, other, other->count);
+                }
+            }
+        }
+        break;
+        default:
+        {
+            /* Now and then split a run off into a list of its own, check it and let it go */
+            if ((mine->count > 0) && ((rand() % 4) == 0))
+            {
+                int first = rand() % mine->count;
+                int last = first + (rand() % (mine->count - first));
+                int count = last - first + 1;
+                int length = list->length;
+                rc = dll_split(&dll_buf_c, index_c, BUFFER_LENGTH, list, node_at(list, first), node_at(list, last));
+                if ((rc != RC_DLLBUF_OK) || (list->length != (length - count)))
+                {
+                    return 1;
+                }
+                model_c.count = 0;
+                model_move(mine, first, count, &model_c, 0);
+                int errors = check(&dll_buf_c, &model_c);
+                /* Its elements are removed in order, and its nodes take new elements */
+                for (int i = 0; i < count; i++)
+                {
+                    errors += ((data_dll_remove(&dll_buf_c, &element, true, 0) != RC_DLLBUF_OK) ||
+                               (element.data != model_c.element[i].data)) ? 1 : 0;
+                }
+                element = (data_t){ .idx = 0, .data = step };
+                errors += (data_dll_add(&dll_buf_c, 0, &element) != RC_DLLBUF_OK) ? 1 : 0;
+                model_c.count = 1;
+                model_c.element[0] = element;
+                errors += check(&dll_buf_c, &model_c);
+                dll_deInit(&dll_buf_c);
+                if (errors != 0)
+                {
+                    return errors;
+                }
+            }
+        }
+        break;
+    }
+    return check(&dll_buf_a, &model_a) + check(&dll_buf_b, &model_b);
+}
+
+int main()
+{
+    printf("\nMoving runs between DLL buffers. Length of buffers: %d\n", BUFFER_LENGTH);
+    data_t element;
+    int errors = 0;
+
+    /* Two lists over their own pools */
+    data_dll_init(&dll_buf_a, data_a, BUFFER_LENGTH);
+    data_dll_init(&dll_buf_b, data_b, BUFFER_LENGTH);
+    for (int i = 0; i < 8; i++)
+    {
+        element = (data_t){ .idx = i, .data = i * 10 };
+        (void) data_dll_add(&dll_buf_a, i, &element);
+    }
+    print_list("List A", &dll_buf_a);
+
+    /* Move the run 5 to 7 to the head, then 1 to 2 to the tail of list B, then split off 6 to 4 */
+    dll_splice(&dll_buf_a, dll_find_node(&dll_buf_a, 5), dll_find_node(&dll_buf_a, 7), NULL);
+    printf("\nSpliced 5 to 7 to the head\n");
+    print_list("List A", &dll_buf_a);
+    (void) dll_transfer(&dll_buf_b, &dll_buf_a, dll_find_node(&dll_buf_a, 1), dll_find_node(&dll_buf_a, 2));
+    printf("\nTransferred 1 to 2 to list B\n");
+    print_list("List A", &dll_buf_a);
+    print_list("List B", &dll_buf_b);
+    (void) dll_split(&dll_buf_c, index_c, BUFFER_LENGTH, &dll_buf_a, dll_find_node(&dll_buf_a, 6), dll_find_node(&dll_buf_a, 4));
+    printf("\nSplit 6 to 4 off list A\n");
+    print_list("List A", &dll_buf_a);
+    print_list("List C", &dll_buf_c);
+    printf("Lengths A: %d, B: %d, C: %d\n", dll_buf_a.length, dll_buf_b.length, dll_buf_c.length);
+    dll_deInit(&dll_buf_c);
+
+    /* Random steps against the model, the lists share nodes once a run was transferred so they restart together */
+    srand(1);
+    for (int step = 0; (step < STEP_COUNT) && (errors == 0); step++)
+    {
+        if ((step % RESTART_PERIOD) == 0)
+        {
+            dll_deInit(&dll_buf_a);
+            dll_deInit(&dll_buf_b);
+            data_dll_init(&dll_buf_a, data_a, BUFFER_LENGTH);
+            data_dll_init(&dll_buf_b, data_b, BUFFER_LENGTH);
+            model_a.count = model_b.count = 0;
+        }
+        errors = random_step(step);
+        if (errors != 0)
+        {
+            printf("\nMismatch with the model at step %d\n", step);
+        }
+    }
+    printf("\n%d random steps: %s\n", STEP_COUNT, (errors == 0) ? "no mismatch with the model" : "ERROR");
+
+    dll_deInit(&dll_buf_a);
+    dll_deInit(&dll_buf_b);
+    printf("\nExited program");
+    return (errors == 0) ? 0 : 1;
+}
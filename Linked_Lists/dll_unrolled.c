@@ -0,0 +1,134 @@
+/* Demonstration of the unrolled DLL buffer in dll_unrolled.h
+    The same list is built in the DLL buffer of dll.h and in the unrolled one, then both are walked
+    from head to tail. Elements are then removed from the middle of the unrolled list, and the
+    blocks they leave almost empty are merged.
+*/
+
+/* Standard libarary includes */
+#include <stdio.h>
+#include <time.h>
+
+/* The counters of -DBUF_STATS and the trace of -DBUF_TRACE are defined in this file */
+#define BUF_STATS_IMPLEMENTATION
+#define BUF_TRACE_IMPLEMENTATION
+
+#include "dll_unrolled.h"
+
+/* Buffer size, and the elements and number of blocks of the unrolled list */
+#define BUFFER_LENGTH           200000
+#define BLOCK_LENGTH            32
+#define BLOCK_COUNT             (BUFFER_LENGTH / BLOCK_LENGTH)
+
+/* Number of walks through the whole list */
+#define WALK_COUNT              50
+
+/* The data organized in structure */
+typedef struct
+{
+    int idx;
+    int data;
+} data_t;
+
+/* Static allocation of data is preferred */
+_Alignas(dll_node_t) unsigned char data[DLL_STORAGE_SIZE(BUFFER_LENGTH, sizeof(data_t))];
+_Alignas(max_align_t) unsigned char unrolled_data[DLL_UNROLLED_STORAGE_SIZE(BLOCK_COUNT, BLOCK_LENGTH, sizeof(data_t))];
+
+dll_buf_t dll_buf_ctrl;
+dll_unrolled_t dll_unrolled_ctrl;
+
+/* Sum of the data of the visited elements */
+long long visit_sum;
+
+void sum_element (int idx, void *element)
+{
+    (void) idx;
+    visit_sum += ((data_t *)element)->data;
+}
+
+/* Function to get the time since start in seconds */
+double seconds_since (struct timespec *start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + ((now.tv_nsec - start->tv_nsec) / 1e9);
+}
+
+/* Function to count the blocks in use */
+int count_blocks (void)
+{
+    int blocks = 0;
+
+    for (dll_block_t *block = dll_unrolled_ctrl.head; block != NULL; block = block->next)
+    {
+        blocks++;
+    }
+    return blocks;
+}
+
+int main()
+{
+    printf("\nUnrolled DLL Buffer Implementation. Length of buffer: %d, blocks of %d\n", BUFFER_LENGTH, BLOCK_LENGTH);
+    struct timespec start;
+    data_t element;
+    long long expected = 0;
+
+    dll_init(&dll_buf_ctrl, data, BUFFER_LENGTH, sizeof(data_t));
+    dll_unrolled_init(&dll_unrolled_ctrl, unrolled_data, BLOCK_COUNT, BLOCK_LENGTH, sizeof(data_t));
+    for (int i = 0; i < BUFFER_LENGTH; i++)
+    {
+        element.idx = i;
+        element.data = i % 1000;
+        expected += element.data;
+        (void) dll_add(&dll_buf_ctrl, element.idx, &element);
+        (void) dll_unrolled_add(&dll_unrolled_ctrl, element.idx, &element);
+    }
+
+    /* Traverse both lists */
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < WALK_COUNT; i++)
+    {
+        visit_sum = 0;
+        (void) dll_traverse(&dll_buf_ctrl, sum_element);
+    }
+    double seconds = seconds_since(&start);
+    printf("Traverse, one element per node: %.2f ns per element, %s\n", (seconds * 1e9) / ((double)WALK_COUNT * BUFFER_LENGTH),
+           (visit_sum == expected) ? "sum correct" : "WRONG SUM");
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < WALK_COUNT; i++)
+    {
+        visit_sum = 0;
+        (void) dll_unrolled_traverse(&dll_unrolled_ctrl, sum_element);
+    }
+    seconds = seconds_since(&start);
+    printf("Traverse, unrolled blocks:      %.2f ns per element, %s\n", (seconds * 1e9) / ((double)WALK_COUNT * BUFFER_LENGTH),
+           (visit_sum == expected) ? "sum correct" : "WRONG SUM");
+
+    /* A remove of a missing index searches the whole unrolled list */
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < WALK_COUNT; i++)
+    {
+        (void) dll_unrolled_remove(&dll_unrolled_ctrl, &element, false, -1);
+    }
+    seconds = seconds_since(&start);
+    printf("Search, unrolled blocks:        %.2f ns per element\n", (seconds * 1e9) / ((double)WALK_COUNT * BUFFER_LENGTH));
+
+    /* Remove most elements of the first 100 blocks, from the middle of each */
+    int errors = 0;
+    printf("\nBlocks in use: %d", count_blocks());
+    for (int i = 0; i < (100 * BLOCK_LENGTH); i++)
+    {
+        if (((i % BLOCK_LENGTH) >= 4) && (dll_unrolled_remove(&dll_unrolled_ctrl, &element, false, i) == RC_DLLBUF_OK))
+        {
+            errors += (element.idx != i) ? 1 : 0;
+        }
+    }
+    printf(", after removing 28 of every 32 elements in 100 blocks: %d, %d errors\n", count_blocks(), errors);
+
+    /* De-init the buffers */
+    dll_deInit(&dll_buf_ctrl);
+    dll_unrolled_deInit(&dll_unrolled_ctrl);
+    printf("\nExited program");
+    return 0;
+}
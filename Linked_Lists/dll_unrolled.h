@@ -0,0 +1,328 @@
+/* An unrolled Doubly Linked List (DLL) buffer, each node holds a block of elements
+    An element can be added only at the tail, but can be removed from anywhere, as in dll.h.
+
+    Every node of the list is a block of up to block_length elements, kept in order, with their
+    indices in one array and their data in another:
+
+     ______________________________________________________
+    |_NEXT_|_PREV_|_START_|_COUNT_|_IDX_|_IDX_|...|_DATA_|_DATA_|...|   Block size = DLL_UNROLLED_BLOCK_SIZE
+                                    ^ start       ^ start + count
+
+    Traversal and the search for an index run a sequential loop over the elements of a block and
+    follow a link only once per block, instead of once per element.
+
+    An element is added after the last one of the tail block, or in a new block when it is full.
+    A remove from the head only moves the start of the head block forward. A remove from the middle
+    closes the gap inside its block, and a block left less than a quarter full is merged with a
+    neighbour when their elements fit in one block. Emptied blocks go back on the free chain.
+*/
+#ifndef DLL_UNROLLED_H
+#define DLL_UNROLLED_H
+
+/* Standard libarary includes */
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/* The return codes and the visit function are shared with the basic DLL buffer */
+#include "dll.h"
+
+/* Header of each block, the indices and the elements follow it */
+typedef struct dll_block_t
+{
+    struct dll_block_t *next;
+    struct dll_block_t *prev;
+    int start;
+    int count;
+} dll_block_t;
+
+/* Function to round a size up to the alignment of any element */
+#define DLL_UNROLLED_ALIGN(size)    (((size) + (_Alignof(max_align_t) - 1u)) & ~(_Alignof(max_align_t) - 1u))
+
+/* Offset of the elements in a block */
+#define DLL_UNROLLED_DATA_OFFSET(block_length) \
+    DLL_UNROLLED_ALIGN(sizeof(dll_block_t) + ((size_t)(block_length) * sizeof(int)))
+
+/* Size of one block of block_length elements of elem_size bytes */
+#define DLL_UNROLLED_BLOCK_SIZE(block_length, elem_size) \
+    DLL_UNROLLED_ALIGN(DLL_UNROLLED_DATA_OFFSET(block_length) + ((size_t)(block_length) * (elem_size)))
+
+/* Size of the block pool the caller must supply for block_count blocks */
+#define DLL_UNROLLED_STORAGE_SIZE(block_count, block_length, elem_size) \
+    ((size_t)(block_count) * DLL_UNROLLED_BLOCK_SIZE(block_length, elem_size))
+
+/* Unrolled DLL buffer structure declaration */
+typedef struct
+{
+    int block_length;
+    int block_count;
+    int alloc_count;
+    size_t elem_size;
+    size_t block_size;
+    size_t data_offset;
+    unsigned char *pool;
+    dll_block_t *head;
+    dll_block_t *tail;
+    dll_block_t *free;
+} dll_unrolled_t;
+
+/* Function to get the indices of a block */
+static inline int *dll_block_idx (dll_block_t *block)
+{
+    return (int *)((unsigned char *)block + sizeof(dll_block_t));
+}
+
+/* Function to get an element of a block */
+static inline void *dll_block_payload (dll_unrolled_t *dll, dll_block_t *block, int position)
+{
+    return (void *)((unsigned char *)block + dll->data_offset + ((size_t)position * dll->elem_size));
+}
+
+/* Function to move count elements inside or between blocks, the ranges may overlap */
+static inline void dll_block_move (dll_unrolled_t *dll, dll_block_t *to, int to_position, dll_block_t *from, int from_position, int count)
+{
+    (void) memmove (&dll_block_idx(to)[to_position], &dll_block_idx(from)[from_position], (size_t)count * sizeof(int));
+    (void) memmove (dll_block_payload(dll, to, to_position), dll_block_payload(dll, from, from_position), (size_t)count * dll->elem_size);
+}
+
+/* Function to move the elements of a block to its start */
+static inline void dll_block_compact (dll_unrolled_t *dll, dll_block_t *block)
+{
+    if (block->start != 0)
+    {
+        dll_block_move(dll, block, 0, block, block->start, block->count);
+        block->start = 0;
+    }
+}
+
+/* Function to unlink a block from the list and put it on the free chain */
+static inline void dll_block_release (dll_unrolled_t *dll, dll_block_t *block)
+{
+    if (block->prev != NULL)
+    {
+        block->prev->next = block->next;
+    }
+    else
+    {
+        dll->head = block->next;
+    }
+    if (block->next != NULL)
+    {
+        block->next->prev = block->prev;
+    }
+    else
+    {
+        dll->tail = block->prev;
+    }
+    block->prev = NULL;
+    block->next = dll->free;
+    dll->free = block;
+}
+
+/* Function to merge a block into the block before it when the elements of both fit in one */
+static inline void dll_block_merge (dll_unrolled_t *dll, dll_block_t *first, dll_block_t *second)
+{
+    if ((first != NULL) && (second != NULL) && ((first->count + second->count) <= dll->block_length))
+    {
+        dll_block_compact(dll, first);
+        dll_block_move(dll, first, first->count, second, second->start, second->count);
+        first->count += second->count;
+        dll_block_release(dll, second);
+    }
+}
+
+/* Function to check if the unrolled DLL buffer is empty */
+static inline dll_rc_t dll_unrolled_is_bufEmpty (dll_unrolled_t *dll)
+{
+    dll_rc_t rc = RC_DLLBUF_OK;
+
+    if (dll->alloc_count == 0)
+    {
+        rc = RC_DLLBUF_ERR_EMPTY;
+    }
+    return rc;
+}
+
+/* Funtion to add an element at the tail of the unrolled DLL buffer */
+static inline dll_rc_t dll_unrolled_add (dll_unrolled_t *dll, int idx, const void *element)
+{
+    dll_rc_t rc = RC_DLLBUF_OK;
+    dll_block_t *block = dll->tail;
+
+    if ((block != NULL) && ((block->start + block->count) == dll->block_length) && (block->count < dll->block_length))
+    {
+        /* Elements were removed from the front of the tail block, make room behind them */
+        dll_block_compact(dll, block);
+    }
+    if ((block == NULL) || (block->count == dll->block_length))
+    {
+        /* Link a new block after the tail */
+        block = dll->free;
+        if (block == NULL)
+        {
+            rc = RC_DLLBUF_ERR_FULL;
+        }
+        else
+        {
+            dll->free = block->next;
+            block->next = NULL;
+            block->prev = dll->tail;
+            block->start = 0;
+            block->count = 0;
+            if (dll->tail != NULL)
+            {
+                dll->tail->next = block;
+            }
+            else
+            {
+                dll->head = block;
+            }
+            dll->tail = block;
+        }
+    }
+
+    if (rc == RC_DLLBUF_OK)
+    {
+        int position = block->start + block->count;
+        dll_block_idx(block)[position] = idx;
+        (void) memcpy (dll_block_payload(dll, block, position), element, dll->elem_size);
+        block->count++;
+        dll->alloc_count++;
+    }
+    return rc;
+}
+
+/* Function to remove an element from the unrolled DLL buffer, from the head in case of conventional remove or by index */
+static inline dll_rc_t dll_unrolled_remove (dll_unrolled_t *dll, void *element, bool conv_remove, int idx)
+{
+    /* Check if the buffer is empty */
+    dll_rc_t rc = dll_unrolled_is_bufEmpty(dll);
+    dll_block_t *block = dll->head;
+    int position = -1;
+
+    if (rc == RC_DLLBUF_OK)
+    {
+        if (conv_remove)
+        {
+            position = block->start;
+        }
+        else
+        {
+            /* Search each block with a sequential loop, follow a link only once per block */
+            while ((block != NULL) && (position < 0))
+            {
+                int *block_idx = dll_block_idx(block);
+                int last = block->start + block->count;
+                for (int i = block->start; i < last; i++)
+                {
+                    if (block_idx[i] == idx)
+                    {
+                        position = i;
+                        break;
+                    }
+                }
+                if (position < 0)
+                {
+                    block = block->next;
+                }
+            }
+            if (position < 0)
+            {
+                rc = RC_DLLBUF_NOT_FOUND;
+            }
+        }
+    }
+
+    if (position >= 0)
+    {
+        (void) memcpy (element, dll_block_payload(dll, block, position), dll->elem_size);
+        if (position == block->start)
+        {
+            /* The first element of a block only moves the start */
+            block->start++;
+        }
+        else
+        {
+            /* Close the gap inside the block */
+            dll_block_move(dll, block, position, block, position + 1, (block->start + block->count) - (position + 1));
+        }
+        block->count--;
+        dll->alloc_count--;
+
+        if (block->count == 0)
+        {
+            dll_block_release(dll, block);
+        }
+        else if ((!conv_remove) && (block->count < (dll->block_length / 4)))
+        {
+            /* Merge a block left almost empty with the neighbour that has room for it */
+            if ((block->next != NULL) && ((block->count + block->next->count) <= dll->block_length))
+            {
+                dll_block_merge(dll, block, block->next);
+            }
+            else
+            {
+                dll_block_merge(dll, block->prev, block);
+            }
+        }
+    }
+    return rc;
+}
+
+/* Function to traverse through the unrolled DLL buffer, from head to tail */
+static inline dll_rc_t dll_unrolled_traverse (dll_unrolled_t *dll, dll_visit_t visit)
+{
+    /* Check if the buffer is empty */
+    dll_rc_t rc = dll_unrolled_is_bufEmpty(dll);
+
+    if (rc == RC_DLLBUF_OK)
+    {
+        for (dll_block_t *block = dll->head; block != NULL; block = block->next)
+        {
+            int *block_idx = dll_block_idx(block);
+            int last = block->start + block->count;
+            for (int i = block->start; i < last; i++)
+            {
+                visit(block_idx[i], dll_block_payload(dll, block, i));
+            }
+        }
+    }
+    return rc;
+}
+
+/* Initialize the unrolled DLL buffer over a caller supplied pool of DLL_UNROLLED_STORAGE_SIZE bytes */
+static inline void dll_unrolled_init (dll_unrolled_t *dll, void *storage, int block_count, int block_length, size_t elem_size)
+{
+    /* Set the buffer size */
+    dll->block_length = block_length;
+    dll->block_count = block_count;
+    dll->elem_size = elem_size;
+    dll->block_size = DLL_UNROLLED_BLOCK_SIZE(block_length, elem_size);
+    dll->data_offset = DLL_UNROLLED_DATA_OFFSET(block_length);
+    dll->pool = (unsigned char *)storage;
+    dll->alloc_count = 0;
+    dll->head = dll->tail = NULL;
+
+    /* Chain every block on the free chain */
+    dll->free = NULL;
+    for (int i = block_count - 1; i >= 0; i--)
+    {
+        dll_block_t *block = (dll_block_t *)(dll->pool + ((size_t)i * dll->block_size));
+        block->prev = NULL;
+        block->next = dll->free;
+        dll->free = block;
+    }
+}
+
+/* De-Initialize the unrolled DLL buffer */
+static inline void dll_unrolled_deInit (dll_unrolled_t *dll)
+{
+    /* Set the buffer size */
+    dll->block_count = 0;
+    dll->alloc_count = 0;
+    dll->pool = NULL;
+    dll->head = dll->tail = dll->free = NULL;
+}
+
+#endif /* DLL_UNROLLED_H */